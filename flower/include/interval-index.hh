@@ -0,0 +1,65 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERVAL_INDEX_HH
+#define INTERVAL_INDEX_HH
+
+#include "std-vector.hh"
+#include "interval.hh"
+
+/*
+  A set of intervals, each with an id, that can be searched for the
+  intervals overlapping a given one.  Intervals can be added one by
+  one, between searches.
+*/
+class Interval_index
+{
+public:
+  Interval_index ();
+
+  void insert (Interval iv, vsize id);
+  void find_overlapping (Interval iv, vector<vsize> *ids) const;
+  vsize size () const { return size_; }
+
+private:
+  /*
+    The intervals are kept in blocks of 1, 2, 4, ... entries, like the
+    digits of a binary number.  Every block is sorted by left end and
+    read as a balanced tree, with the middle entry of a range as its
+    root.  For every root, max_right_ holds the largest right end in
+    its range.
+  */
+  struct Block
+  {
+    vector<Interval> intervals_;
+    vector<vsize> ids_;
+    vector<Real> max_right_;
+  };
+
+  vector<Block> blocks_;
+  vsize size_;
+
+  static bool left_less (pair<Interval, vsize> const &,
+                         pair<Interval, vsize> const &);
+  static Real build (Block *b, vsize lo, vsize hi);
+  static void search (Block const &b, vsize lo, vsize hi,
+                      Interval iv, vector<vsize> *ids);
+};
+
+#endif /* INTERVAL_INDEX_HH */
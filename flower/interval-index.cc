@@ -0,0 +1,126 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "interval-index.hh"
+
+/*
+  Adding an interval merges all full blocks below the first empty one
+  into it, so every interval is moved O(log n) times.  A search visits
+  every block, at O(log n) per block plus the intervals found.
+*/
+
+Interval_index::Interval_index ()
+{
+  size_ = 0;
+}
+
+void
+Interval_index::insert (Interval iv, vsize id)
+{
+  Block carry;
+  carry.intervals_.push_back (iv);
+  carry.ids_.push_back (id);
+
+  vsize k = 0;
+  for (; k < blocks_.size () && !blocks_[k].ids_.empty (); k++)
+    {
+      carry.intervals_.insert (carry.intervals_.end (),
+                               blocks_[k].intervals_.begin (),
+                               blocks_[k].intervals_.end ());
+      carry.ids_.insert (carry.ids_.end (),
+                         blocks_[k].ids_.begin (), blocks_[k].ids_.end ());
+      blocks_[k] = Block ();
+    }
+  if (k == blocks_.size ())
+    blocks_.push_back (Block ());
+
+  vector<pair<Interval, vsize> > entries;
+  for (vsize i = 0; i < carry.ids_.size (); i++)
+    entries.push_back (make_pair (carry.intervals_[i], carry.ids_[i]));
+  sort (entries.begin (), entries.end (), left_less);
+
+  Block &b = blocks_[k];
+  for (vsize i = 0; i < entries.size (); i++)
+    {
+      b.intervals_.push_back (entries[i].first);
+      b.ids_.push_back (entries[i].second);
+    }
+  b.max_right_.resize (entries.size ());
+  build (&b, 0, entries.size ());
+  size_++;
+}
+
+bool
+Interval_index::left_less (pair<Interval, vsize> const &a,
+                           pair<Interval, vsize> const &b)
+{
+  return a.first[LEFT] < b.first[LEFT];
+}
+
+Real
+Interval_index::build (Block *b, vsize lo, vsize hi)
+{
+  if (lo >= hi)
+    return -infinity_f;
+
+  vsize mid = lo + (hi - lo) / 2;
+  Real right = b->intervals_[mid][RIGHT];
+  right = max (right, build (b, lo, mid));
+  right = max (right, build (b, mid + 1, hi));
+  b->max_right_[mid] = right;
+  return right;
+}
+
+void
+Interval_index::search (Block const &b, vsize lo, vsize hi,
+                        Interval iv, vector<vsize> *ids)
+{
+  if (lo >= hi)
+    return;
+
+  vsize mid = lo + (hi - lo) / 2;
+  if (b.max_right_[mid] < iv[LEFT])
+    return;
+
+  search (b, lo, mid, iv, ids);
+
+  // Everything from here on starts to the right of IV.
+  Interval const &here = b.intervals_[mid];
+  if (here[LEFT] > iv[RIGHT])
+    return;
+
+  if (here[RIGHT] >= iv[LEFT] && !here.is_empty ())
+    ids->push_back (b.ids_[mid]);
+  search (b, mid + 1, hi, iv, ids);
+}
+
+/*
+  Add the ids of all intervals that overlap IV, including those that
+  only touch it, to IDS.  The order of the ids is unspecified.
+*/
+void
+Interval_index::find_overlapping (Interval iv, vector<vsize> *ids) const
+{
+  if (iv.is_empty ())
+    return;
+
+  for (vsize k = 0; k < blocks_.size (); k++)
+    if (!blocks_[k].ids_.empty ())
+      search (blocks_[k], 0, blocks_[k].ids_.size (), iv, ids);
+}
@@ -19,6 +19,7 @@
 
 #include "rational.hh"
 
+#include <algorithm>
 #include <cmath>
 #include <cassert>
 #include <cstdlib>
@@ -177,6 +178,17 @@ b3:
   return result;
 }
 
+/*
+  Durations nearly always have power-of-two denominators.  For those,
+  the gcd with any numerator is the lowest set bit of the numerator,
+  bounded by the denominator, so no gcd loop is needed.
+*/
+static inline bool
+is_power_of_two (U64 x)
+{
+  return !(x & (x - 1));
+}
+
 void
 Rational::normalize ()
 {
@@ -195,6 +207,15 @@ Rational::normalize ()
       sign_ = 0;
       den_ = 1;
     }
+  else if (is_power_of_two (den_))
+    {
+      U64 g = num_ & (~num_ + 1);
+      if (g > den_)
+        g = den_;
+
+      num_ /= g;
+      den_ /= g;
+    }
   else
     {
       I64 g = gcd (num_, den_);
@@ -220,6 +241,8 @@ Rational::compare (Rational const &r, Rational const &s)
     return 0;
   else if (r.sign_ == 0) // here s.sign_ is also zero
     return 0;
+  else if (r.den_ == s.den_) // same sign, finite
+    return r.num_ == s.num_ ? 0 : (r.num_ < s.num_ ? -r.sign_ : r.sign_);
   return ::sign (r - s);
 }
 
@@ -245,7 +268,11 @@ Rational::operator += (Rational r)
     *this = r;
   else
     {
-      I64 lcm = (den_ / gcd (r.den_, den_)) * r.den_;
+      I64 lcm;
+      if (is_power_of_two (den_) && is_power_of_two (r.den_))
+        lcm = max (den_, r.den_);
+      else
+        lcm = (den_ / gcd (r.den_, den_)) * r.den_;
       I64 n = sign_ * num_ * (lcm / den_) + r.sign_ * r.num_ * (lcm / r.den_);
       I64 d = lcm;
       sign_ = ::sign (n) * ::sign (d);
@@ -0,0 +1,91 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "interval-index.hh"
+
+#include "yaffut.hh"
+
+using namespace std;
+
+static vector<vsize>
+overlapping (Interval_index const &index, Interval iv)
+{
+  vector<vsize> ids;
+  index.find_overlapping (iv, &ids);
+  vector_sort (ids, less<vsize> ());
+  return ids;
+}
+
+FUNC (interval_index_find_overlapping)
+{
+  Interval_index index;
+  index.insert (Interval (0, 1), 0);
+  index.insert (Interval (2, 3), 1);
+  index.insert (Interval (-10, 10), 2);
+  index.insert (Interval (4, 5), 3);
+  index.insert (Interval (infinity_f, -infinity_f), 4);
+  EQUAL (index.size (), 5);
+
+  vector<vsize> ids = overlapping (index, Interval (1.5, 2.5));
+  EQUAL (ids.size (), 2);
+  EQUAL (ids[0], 1);
+  EQUAL (ids[1], 2);
+
+  // Touching intervals overlap.
+  ids = overlapping (index, Interval (5, 20));
+  EQUAL (ids.size (), 2);
+  EQUAL (ids[0], 2);
+  EQUAL (ids[1], 3);
+
+  ids = overlapping (index, Interval (11, 20));
+  EQUAL (ids.size (), 0);
+
+  // Empty intervals overlap nothing.
+  ids = overlapping (index, Interval (infinity_f, -infinity_f));
+  EQUAL (ids.size (), 0);
+
+  ids = overlapping (index, Interval (-infinity_f, infinity_f));
+  EQUAL (ids.size (), 4);
+}
+
+FUNC (interval_index_brute_force)
+{
+  Interval_index index;
+  vector<Interval> ivs;
+  for (vsize i = 0; i < 100; i++)
+    {
+      Real left = Real ((i * 37) % 101);
+      ivs.push_back (Interval (left, left + Real ((i * 13) % 17)));
+      index.insert (ivs.back (), i);
+
+      for (Real x = -5; x < 110; x += 7.5)
+        {
+          Interval q (x, x + 3);
+          vector<vsize> expected;
+          for (vsize j = 0; j < ivs.size (); j++)
+            if (!intersection (ivs[j], q).is_empty ())
+              expected.push_back (j);
+          vector<vsize> found = overlapping (index, q);
+          EQUAL (found.size (), expected.size ());
+          for (vsize j = 0; j < found.size (); j++)
+            EQUAL (found[j], expected[j]);
+        }
+    }
+}
@@ -0,0 +1,52 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "rational.hh"
+
+#include "yaffut.hh"
+
+using namespace std;
+
+FUNC (rational_power_of_two_normalize)
+{
+  EQUAL (Rational (12, 16).to_string (), "3/4");
+  EQUAL (Rational (-8, 32).to_string (), "-1/4");
+  EQUAL (Rational (64, 16).to_string (), "4");
+  EQUAL (Rational (3, 8).to_string (), "3/8");
+  // Not a power of two.
+  EQUAL (Rational (6, 9).to_string (), "2/3");
+}
+
+FUNC (rational_power_of_two_add)
+{
+  EQUAL ((Rational (1, 4) + Rational (1, 8)).to_string (), "3/8");
+  EQUAL ((Rational (3, 8) + Rational (5, 8)).to_string (), "1");
+  EQUAL ((Rational (1, 2) - Rational (3, 4)).to_string (), "-1/4");
+  EQUAL ((Rational (1, 4) + Rational (1, 3)).to_string (), "7/12");
+  EQUAL ((Rational (1, 16) + Rational (-1, 16)).to_string (), "0");
+}
+
+FUNC (rational_compare_same_denominator)
+{
+  EQUAL (Rational::compare (Rational (1, 8), Rational (3, 8)), -1);
+  EQUAL (Rational::compare (Rational (3, 8), Rational (1, 8)), 1);
+  EQUAL (Rational::compare (Rational (-1, 8), Rational (-3, 8)), 1);
+  EQUAL (Rational::compare (Rational (-3, 8), Rational (-3, 8)), 0);
+  EQUAL (Rational::compare (Rational (1, 3), Rational (1, 4)), 1);
+}
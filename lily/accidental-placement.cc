@@ -404,10 +404,8 @@ position_apes (Grob *me,
       else
         offset -= padding;
 
-      Skyline new_left_skyline = ape->horizontal_skylines_[LEFT];
-      new_left_skyline.raise (offset);
-      new_left_skyline.merge (left_skyline);
-      left_skyline = new_left_skyline;
+      /* Grow the column outline in place with this ape.  */
+      left_skyline.merge (ape->horizontal_skylines_[LEFT], offset);
 
       /* Shift all of the accidentals in this ape */
       for (vsize j = ape->grobs_.size (); j--;)
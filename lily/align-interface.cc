@@ -173,8 +173,17 @@ Align_interface::internal_get_minimum_translations (Grob *me,
   if (!pure && a == Y_AXIS && dynamic_cast<Spanner *> (me) && !me->get_system ())
     me->programming_error ("vertical alignment called before line-breaking");
 
-  // check the cache
-  if (pure)
+  // check the cache.  There is an entry for every system candidate, so
+  // spanners keep theirs in the pure property cache instead of the alist.
+  Spanner *sp = dynamic_cast<Spanner *> (me);
+  SCM cache_symbol = ly_symbol2scm ("minimum-translations");
+  if (pure && sp)
+    {
+      SCM fv = sp->get_cached_pure_property (cache_symbol, start, end);
+      if (!SCM_UNBNDP (fv))
+        return ly_scm2floatvector (fv);
+    }
+  else if (pure)
     {
       SCM fv = ly_assoc_get (scm_cons (scm_from_int (start), scm_from_int (end)),
                              me->get_property ("minimum-translations-alist"),
@@ -278,7 +287,10 @@ Align_interface::internal_get_minimum_translations (Grob *me,
       last_nonempty_element = elems[j];
     }
 
-  if (pure)
+  if (pure && sp)
+    sp->cache_pure_property (cache_symbol, start, end,
+                             ly_floatvector2scm (translates));
+  else if (pure)
     {
       SCM mta = me->get_property ("minimum-translations-alist");
       mta = scm_cons (scm_cons (scm_cons (scm_from_int (start), scm_from_int (end)),
@@ -26,6 +26,7 @@
 #include "grob-array.hh"
 #include "hara-kiri-group-spanner.hh"
 #include "international.hh"
+#include "interval-index.hh"
 #include "interval-set.hh"
 #include "lookup.hh"
 #include "paper-column.hh"
@@ -665,24 +666,56 @@ add_interior_skylines (Grob *me, Grob *x_common, Grob *y_common, vector<Skyline_
     }
 }
 
+// The horizontal range in which a skyline with the given horizon
+// padding can affect the distance to others; see Skyline::padded.
+static Interval
+skyline_reach (Skyline_pair const &skyp, Real horizon_padding)
+{
+  Interval reach (min (skyp[UP].left (), skyp[DOWN].left ()),
+                  max (skyp[UP].right (), skyp[DOWN].right ()));
+  reach.widen (2 * horizon_padding);
+  return reach;
+}
+
 // Raises the grob elt (whose skylines are given by h_skyline
 // and v_skyline) so that it doesn't intersect with staff_skyline,
 // or with anything in other_h_skylines and other_v_skylines.
+// other_reach indexes the skylines by skyline_reach, so that only
+// those within reach of v_skyline need to be looked at.  Of the
+// staff skyline, which spans the whole system, only the section
+// within reach is looked at.
 void
 avoid_outside_staff_collisions (Grob *elt,
                                 Skyline_pair *v_skyline,
                                 Real padding,
                                 Real horizon_padding,
+                                Drul_array<Skyline_index> const &staff_skyline,
                                 vector<Skyline_pair> const &other_v_skylines,
                                 vector<Real> const &other_padding,
                                 vector<Real> const &other_horizon_padding,
+                                Interval_index const &other_reach,
                                 Direction const dir)
 {
   assert (other_v_skylines.size () == other_padding.size ());
   assert (other_v_skylines.size () == other_horizon_padding.size ());
+  assert (other_v_skylines.size () == other_reach.size ());
+  Interval reach = skyline_reach (*v_skyline, horizon_padding);
   vector<Interval> forbidden_intervals;
-  for (vsize j = 0; j < other_v_skylines.size (); j++)
+
+  // The staff has no padding of its own.
+  Real staff_pad = max (padding, 0.0);
+  Real staff_horizon_pad = max (horizon_padding, 0.0);
+  Real up = (*v_skyline)[DOWN].distance (staff_skyline[UP].section (reach),
+                                         staff_horizon_pad) + staff_pad;
+  Real down = (*v_skyline)[UP].distance (staff_skyline[DOWN].section (reach),
+                                         staff_horizon_pad) + staff_pad;
+  forbidden_intervals.push_back (Interval (-down, up));
+
+  vector<vsize> nearby;
+  other_reach.find_overlapping (reach, &nearby);
+  for (vsize k = 0; k < nearby.size (); k++)
     {
+      vsize j = nearby[k];
       Skyline_pair const &v_other = other_v_skylines[j];
       Real pad = max (padding, other_padding[j]);
       Real horizon_pad = max (horizon_padding, other_horizon_padding[j]);
@@ -725,9 +758,11 @@ valid_outside_staff_placement_directive (Grob *me)
 // of the grobs in elements will be added to all_v_skylines.
 static void
 add_grobs_of_one_priority (Grob *me,
+                           Drul_array<Skyline_index> const &staff_skyline,
                            Drul_array<vector<Skyline_pair> > *all_v_skylines,
                            Drul_array<vector<Real> > *all_paddings,
                            Drul_array<vector<Real> > *all_horizon_paddings,
+                           Drul_array<Interval_index> *all_reaches,
                            vector<Grob *> elements,
                            Grob *x_common,
                            Grob *y_common,
@@ -826,12 +861,16 @@ add_grobs_of_one_priority (Grob *me,
                                           &v_skylines,
                                           padding,
                                           horizon_padding,
+                                          staff_skyline,
                                           (*all_v_skylines)[dir],
                                           (*all_paddings)[dir],
                                           (*all_horizon_paddings)[dir],
+                                          (*all_reaches)[dir],
                                           dir);
 
           elt->set_property ("outside-staff-priority", SCM_BOOL_F);
+          (*all_reaches)[dir].insert (skyline_reach (v_skylines, horizon_padding),
+                                      (*all_v_skylines)[dir].size ());
           (*all_v_skylines)[dir].push_back (v_skylines);
           (*all_paddings)[dir].push_back (padding);
           (*all_horizon_paddings)[dir].push_back (horizon_padding);
@@ -922,6 +961,9 @@ Axis_group_interface::skyline_spacing (Grob *me)
     }
 
   Skyline_pair skylines (inside_staff_skylines);
+  Drul_array<Skyline_index> staff_skyline;
+  for (UP_and_DOWN (d))
+    staff_skyline[d] = Skyline_index (skylines[d]);
 
   // These are the skylines of all outside-staff grobs
   // that have already been processed.  We keep them around in order to
@@ -929,12 +971,7 @@ Axis_group_interface::skyline_spacing (Grob *me)
   Drul_array<vector<Skyline_pair> > all_v_skylines;
   Drul_array<vector<Real> > all_paddings;
   Drul_array<vector<Real> > all_horizon_paddings;
-  for (UP_and_DOWN (d))
-    {
-      all_v_skylines[d].push_back (skylines);
-      all_paddings[d].push_back (0);
-      all_horizon_paddings[d].push_back (0);
-    }
+  Drul_array<Interval_index> all_reaches;
 
   for (; i < elements.size (); i++)
     {
@@ -954,9 +991,11 @@ Axis_group_interface::skyline_spacing (Grob *me)
         }
 
       add_grobs_of_one_priority (me,
+                                 staff_skyline,
                                  &all_v_skylines,
                                  &all_paddings,
                                  &all_horizon_paddings,
+                                 &all_reaches,
                                  current_elts,
                                  x_common,
                                  y_common,
@@ -965,9 +1004,9 @@ Axis_group_interface::skyline_spacing (Grob *me)
 
   // Now everything in all_v_skylines has been shifted appropriately; merge
   // them all into skylines to get the complete outline.
-  Skyline_pair other_skylines (all_v_skylines[UP]);
-  other_skylines.merge (Skyline_pair (all_v_skylines[DOWN]));
-  skylines.merge (other_skylines);
+  for (UP_and_DOWN (d))
+    if (!all_v_skylines[d].empty ())
+      skylines.merge (Skyline_pair (all_v_skylines[d]));
 
   // We began by shifting my skyline to be relative to the common refpoint; now
   // shift it back.
@@ -36,10 +36,12 @@ using namespace std;
 #include "interval-minefield.hh"
 #include "least-squares.hh"
 #include "libc-extension.hh"
+#include "lily-imports.hh"
 #include "main.hh"
 #include "note-head.hh"
 #include "output-def.hh"
 #include "pointer-group-interface.hh"
+#include "program-option.hh"
 #include "spanner.hh"
 #include "staff-symbol-referencer.hh"
 #include "stencil.hh"
@@ -395,6 +397,7 @@ Beam_scoring_problem::Beam_scoring_problem (Grob *me, Drul_array<Real> ys, bool
   beam_ = dynamic_cast<Spanner *> (me);
   unquanted_y_ = ys;
   align_broken_intos_ = align_broken_intos;
+  scorer_calls_ = 0;
 
   parameters_.fill (me);
   init_instance_variables (me, ys, align_broken_intos);
@@ -906,7 +909,7 @@ Beam_scoring_problem::generate_quants (vector<Beam_configuration *> *scores) con
 
 void Beam_scoring_problem::one_scorer (Beam_configuration *config) const
 {
-  score_count++;
+  scorer_calls_++;
   switch (config->next_scorer_todo)
     {
     case SLOPE_IDEAL:
@@ -963,6 +966,92 @@ Beam_scoring_problem::force_score (SCM inspect_quants, const vector<Beam_configu
   return best;
 }
 
+/*
+  Score CONFIGS lazily, cheapest scorers first, until the best one is
+  completely scored.  This looks at no grob, so it is safe to run on
+  any thread.
+*/
+Beam_configuration *
+Beam_scoring_problem::best_configuration (vector<Beam_configuration *> const &configs) const
+{
+  std::priority_queue < Beam_configuration *, std::vector<Beam_configuration *>,
+      Beam_configuration_less > queue;
+  for (vsize i = 0; i < configs.size (); i++)
+    queue.push (configs[i]);
+
+  /*
+    TODO
+
+    It would be neat if we generated new configurations on the
+    fly, depending on the best complete score so far, eg.
+
+    if (best->done()) {
+      if (best->demerits < sqrt(queue.size())
+        break;
+      while (best->demerits > sqrt(queue.size()) {
+        generate and insert new configuration
+      }
+    }
+
+    that would allow us to do away with region_size altogether.
+  */
+  Beam_configuration *best = NULL;
+  while (true)
+    {
+      best = queue.top ();
+      if (best->done ())
+        break;
+
+      queue.pop ();
+      one_scorer (best);
+      queue.push (best);
+    }
+  return best;
+}
+
+/*
+  Does solve () do nothing but search () and count_scorers ()?  It
+  does more for debugging, forced quants and broken beams that are
+  aligned with their siblings.
+*/
+bool
+Beam_scoring_problem::has_plain_solution () const
+{
+  if (align_broken_intos_
+      || to_boolean (beam_->get_property ("skip-quanting"))
+      || scm_is_pair (beam_->get_property ("inspect-quants")))
+    return false;
+
+  return !to_boolean (beam_->layout ()
+                      ->lookup_variable (ly_symbol2scm ("debug-beam-scoring")));
+}
+
+/*
+  Find the best positions without touching any grob or Scheme value,
+  so this can run on a worker thread.  Return false if there is no
+  viable configuration.
+*/
+bool
+Beam_scoring_problem::search (Interval *positions) const
+{
+  vector<Beam_configuration *> configs;
+  generate_quants (&configs);
+  if (configs.empty ())
+    return false;
+
+  *positions = best_configuration (configs)->y;
+  junk_pointers (configs);
+  return true;
+}
+
+/* Add the scorers run so far to the ly:beam-score-count total.  */
+void
+Beam_scoring_problem::count_scorers () const
+{
+  score_count += scorer_calls_;
+  scorer_calls_ = 0;
+}
+
 Drul_array<Real>
 Beam_scoring_problem::solve () const
 {
@@ -989,41 +1078,10 @@ Beam_scoring_problem::solve () const
       best = force_score (inspect_quants, configs);
     }
   else
-    {
-      std::priority_queue < Beam_configuration *, std::vector<Beam_configuration *>,
-          Beam_configuration_less > queue;
-      for (vsize i = 0; i < configs.size (); i++)
-        queue.push (configs[i]);
-
-      /*
-        TODO
-
-        It would be neat if we generated new configurations on the
-        fly, depending on the best complete score so far, eg.
-
-        if (best->done()) {
-          if (best->demerits < sqrt(queue.size())
-            break;
-          while (best->demerits > sqrt(queue.size()) {
-            generate and insert new configuration
-          }
-        }
-
-        that would allow us to do away with region_size altogether.
-      */
-      while (true)
-        {
-          best = queue.top ();
-          if (best->done ())
-            break;
-
-          queue.pop ();
-          one_scorer (best);
-          queue.push (best);
-        }
-    }
+    best = best_configuration (configs);
 
   Interval final_positions = best->y;
+  count_scorers ();
 
 #if DEBUG_BEAM_SCORING
   if (debug)
@@ -1054,6 +1112,134 @@ Beam_scoring_problem::solve () const
   return final_positions;
 }
 
+#if SCM_USE_PTHREAD_THREADS
+/*
+  Worker K searches problems K, K + JOBS, K + 2 * JOBS, ...
+*/
+struct Beam_search_job
+{
+  vector<Beam_scoring_problem *> const *problems_;
+  vector<Interval> *positions_;
+  vector<char> *found_;
+  vsize first_;
+  vsize step_;
+};
+
+static SCM
+beam_search_body (void *data)
+{
+  Beam_search_job *job = static_cast<Beam_search_job *> (data);
+  for (vsize i = job->first_; i < job->problems_->size (); i += job->step_)
+    (*job->found_)[i] = (*job->problems_)[i]->search (&(*job->positions_)[i]);
+  return SCM_UNSPECIFIED;
+}
+
+static SCM
+beam_search_handler (void *, SCM, SCM)
+{
+  return SCM_UNSPECIFIED;
+}
+#endif
+
+/*
+  Quant the beams among GROBS whose positions come from the default
+  callback and that are not cross-staff, searching on JOBS threads.
+  Their scoring problems are set up here, on the calling thread; the
+  searches do not touch any grob.  The results become the positions
+  property, just as if the callback had been run.  Beams that need
+  anything beyond the plain search are left to the callback.
+*/
+void
+Beam::quant_in_advance (vector<Grob *> const &grobs, int jobs)
+{
+#if SCM_USE_PTHREAD_THREADS
+  SCM callback = Lily::beam_place_broken_parts_individually;
+  SCM sym = ly_symbol2scm ("positions");
+  vector<Grob *> beams;
+  vector<Beam_scoring_problem *> problems;
+  for (vsize i = 0; i < grobs.size (); i++)
+    {
+      Grob *g = grobs[i];
+      if (!has_interface<Beam> (g)
+          || !scm_is_eq (g->internal_get_property_data (sym), callback)
+          || to_boolean (g->get_property ("cross-staff")))
+        continue;
+
+      Beam_scoring_problem *p
+        = new Beam_scoring_problem (g, Drul_array<Real> (infinity_f, -infinity_f),
+                                    false);
+      if (p->has_plain_solution ())
+        {
+          beams.push_back (g);
+          problems.push_back (p);
+        }
+      else
+        delete p;
+    }
+
+  jobs = min (jobs, int (problems.size ()));
+  if (jobs < 2)
+    {
+      junk_pointers (problems);
+      return;
+    }
+
+  debug_output (_f ("Quanting %d beams with %d threads",
+                    int (problems.size ()), jobs), false);
+
+  vector<Interval> positions (problems.size ());
+  vector<char> found (problems.size (), 0);
+  SCM threads = SCM_EOL;
+  vector<Beam_search_job> work (jobs);
+  for (int k = 0; k < jobs; k++)
+    {
+      work[k].problems_ = &problems;
+      work[k].positions_ = &positions;
+      work[k].found_ = &found;
+      work[k].first_ = k;
+      work[k].step_ = jobs;
+      threads = scm_cons (scm_spawn_thread (beam_search_body, &work[k],
+                                            beam_search_handler, 0),
+                          threads);
+    }
+  for (SCM s = threads; scm_is_pair (s); s = scm_cdr (s))
+    scm_join_thread (scm_car (s));
+
+  bool verify = to_boolean (ly_get_option (ly_symbol2scm ("verify-parallel-quanting")));
+  for (vsize i = 0; i < problems.size (); i++)
+    {
+      problems[i]->count_scorers ();
+
+      /* Someone may have asked for the positions meanwhile.  */
+      if (!found[i]
+          || !scm_is_eq (beams[i]->internal_get_property_data (sym), callback))
+        continue;
+
+      if (verify)
+        {
+          Interval serial = problems[i]->solve ();
+          if (serial[LEFT] != positions[i][LEFT]
+              || serial[RIGHT] != positions[i][RIGHT])
+            {
+              beams[i]->programming_error ("parallel beam quanting differs"
+                                           " from serial quanting");
+              positions[i] = serial;
+            }
+        }
+      beams[i]->internal_set_property (sym, ly_interval2scm (positions[i]));
+    }
+  junk_pointers (problems);
+#else
+  (void) grobs;
+  static bool warned = false;
+  if (jobs > 1 && !warned)
+    {
+      warning (_ ("Guile has no thread support; quanting beams serially"));
+      warned = true;
+    }
+#endif
+}
+
 void
 Beam_scoring_problem::score_stem_lengths (Beam_configuration *config) const
 {
@@ -21,15 +21,51 @@
 #include <cstdlib>
 using namespace std;
 
+#include "break-substitution.hh"
 #include "item.hh"
 #include "system.hh"
 #include "grob-array.hh"
 
 static SCM break_criterion;
+static System *break_line;
 void
 set_break_subsititution (SCM criterion)
 {
   break_criterion = criterion;
+  break_line = unsmob<System> (criterion);
+}
+
+/*
+  Substitute SC into LINE, which may be null.
+*/
+static Grob *
+substitute_grob_into_line (Grob *sc, System *line)
+{
+  if (sc->get_system () != line)
+    sc = sc->find_broken_piece (line);
+
+  /* now: !sc || (sc && sc->get_system () == line) */
+  if (!sc)
+    return 0;
+
+  /* now: sc && sc->get_system () == line */
+  if (!line)
+    return sc;
+
+  /*
+    We don't return SCM_UNDEFINED for
+    suicided grobs, for two reasons
+
+    - it doesn't work (strange disappearing objects)
+
+    - it forces us to mark the parents of a grob, leading to
+    a huge recursion in the GC routine.
+  */
+
+  if (sc->common_refpoint (line, X_AXIS)
+      && sc->common_refpoint (line, Y_AXIS))
+    return sc;
+  return 0;
 }
 
 /*
@@ -50,33 +86,13 @@ substitute_grob (Grob *sc)
     }
   else
     {
-      System *line
-        = unsmob<System> (break_criterion);
-      if (sc->get_system () != line)
-        sc = sc->find_broken_piece (line);
-
-      /* now: !sc || (sc && sc->get_system () == line) */
-      if (!sc)
-        return 0;
-
-      /* now: sc && sc->get_system () == line */
-      if (!line)
-        return sc;
-
-      /*
-        We don't return SCM_UNDEFINED for
-        suicided grobs, for two reasons
-
-        - it doesn't work (strange disappearing objects)
+      Break_substitution_table *table = Break_substitution_table::current ();
+      if (table && break_line
+          && table->has_grob (sc)
+          && table->system_range (sc).contains (break_line->get_rank ()))
+        return table->substitute (sc, break_line->get_rank ());
 
-        - it forces us to mark the parents of a grob, leading to
-        a huge recursion in the GC routine.
-      */
-
-      if (sc->common_refpoint (line, X_AXIS)
-          && sc->common_refpoint (line, Y_AXIS))
-        return sc;
-      return 0;
+      return substitute_grob_into_line (sc, break_line);
     }
 
   return sc;
@@ -241,6 +257,82 @@ grob_system_range (Grob *g)
     return Slice ();
 }
 
+Break_substitution_table *Break_substitution_table::current_ = 0;
+
+Break_substitution_table::Break_substitution_table (System *root)
+{
+  lookup_count_ = 0;
+  resolve_count_ = 0;
+
+  for (vsize i = 0; i < root->broken_intos_.size (); i++)
+    systems_.push_back (dynamic_cast<System *> (root->broken_intos_[i]));
+
+  vector<Grob *> const &all = root->all_elements_->array ();
+  vsize slots = 0;
+  for (vsize i = 0; i < all.size (); i++)
+    {
+      Grob *g = all[i];
+      if (has_grob (g))
+        continue;
+
+      Slice sr = grob_system_range (g);
+      sr.intersect (Slice (0, int (systems_.size ()) - 1));
+
+      g->break_substitution_index_ = grobs_.size ();
+      grobs_.push_back (g);
+      ranges_.push_back (sr);
+      offsets_.push_back (slots);
+      if (!sr.is_empty ())
+        slots += sr.length () + 1;
+    }
+
+  substitutes_.resize (slots, 0);
+  known_.resize (slots, false);
+
+  assert (!current_);
+  current_ = this;
+}
+
+Break_substitution_table::~Break_substitution_table ()
+{
+  for (vsize i = 0; i < grobs_.size (); i++)
+    grobs_[i]->break_substitution_index_ = VPOS;
+  current_ = 0;
+}
+
+bool
+Break_substitution_table::has_grob (Grob const *g) const
+{
+  vsize idx = g->break_substitution_index_;
+  return idx < grobs_.size () && grobs_[idx] == g;
+}
+
+Slice
+Break_substitution_table::system_range (Grob const *g) const
+{
+  return ranges_[g->break_substitution_index_];
+}
+
+/*
+  Substitute G into the system with RANK, which must be in
+  system_range (G).
+*/
+Grob *
+Break_substitution_table::substitute (Grob *g, int rank)
+{
+  vsize idx = g->break_substitution_index_;
+  vsize slot = offsets_[idx] + rank - ranges_[idx][LEFT];
+
+  lookup_count_++;
+  if (!known_[slot])
+    {
+      substitutes_[slot] = substitute_grob_into_line (g, systems_[rank]);
+      known_[slot] = true;
+      resolve_count_++;
+    }
+  return substitutes_[slot];
+}
+
 struct Substitution_entry
 {
   Grob *grob_;
@@ -303,6 +395,49 @@ Spanner::fast_substitute_grob_array (SCM sym,
   if (len < 15)
     return false;
 
+  Slice system_range = spanner_system_range (this);
+
+  if (Break_substitution_table *table = Break_substitution_table::current ())
+    {
+      bool complete = true;
+      for (int i = 0; complete && i < len; i++)
+        complete = table->has_grob (grob_array->grob (i));
+
+      if (complete)
+        {
+          /*
+            Walk the array once, adding each grob to the pieces of the
+            systems it can appear in.  No sorting, no temporary copies.
+          */
+          assert ((broken_intos_.size () == (vsize)system_range.length () + 1)
+                  || (broken_intos_.empty () && system_range.length () == 0));
+
+          vector<Grob_array *> new_arrays;
+          for (vsize i = 0; i < broken_intos_.size (); i++)
+            {
+              Grob *sc = broken_intos_[i];
+              SCM newval = sc->internal_get_object (sym);
+              if (!unsmob<Grob_array> (newval))
+                {
+                  newval = Grob_array::make_array ();
+                  sc->set_object (sym, newval);
+                }
+              new_arrays.push_back (unsmob<Grob_array> (newval));
+            }
+
+          for (int i = 0; i < len; i++)
+            {
+              Grob *g = grob_array->grob (i);
+              Slice sr = table->system_range (g);
+              sr.intersect (system_range);
+              for (int r = sr[LEFT]; r <= sr[RIGHT]; r++)
+                if (Grob *substituted = table->substitute (g, r))
+                  new_arrays[r - system_range[LEFT]]->add (substituted);
+            }
+          return true;
+        }
+    }
+
   /*
     We store items on the left, spanners on the right in this vector.
 
@@ -317,8 +452,6 @@ Spanner::fast_substitute_grob_array (SCM sym,
       vec_room = len;
     }
 
-  Slice system_range = spanner_system_range (this);
-
   int spanner_index = len;
   int item_index = 0;
 
@@ -426,6 +559,34 @@ Spanner::fast_substitute_grob_array (SCM sym,
 SCM
 substitute_object_alist (SCM alist, SCM dest)
 {
+  if (scm_is_eq (alist, dest))
+    {
+      /*
+        Substituting a grob's own links: reuse the cells of ALIST and
+        filter grob arrays in place instead of consing a new list.
+      */
+      SCM *tail = &alist;
+      while (scm_is_pair (*tail))
+        {
+          SCM entry = scm_car (*tail);
+          SCM val = scm_cdr (entry);
+
+          if (Grob_array *arr = unsmob<Grob_array> (val))
+            arr->filter_map (substitute_grob);
+          else
+            {
+              val = do_break_substitution (val);
+              scm_set_cdr_x (entry, val);
+            }
+
+          if (SCM_UNBNDP (val))
+            *tail = scm_cdr (*tail);
+          else
+            tail = SCM_CDRLOC (*tail);
+        }
+      return alist;
+    }
+
   SCM l = SCM_EOL;
   SCM *tail = &l;
   for (SCM s = alist; scm_is_pair (s); s = scm_cdr (s))
@@ -0,0 +1,366 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Glyph subsetting for name-keyed CFF fonts (Adobe TN 5176).
+
+  Unused glyphs keep their slot and their name, but get an empty
+  charstring.  Glyph indices, the charset and the encoding therefore
+  stay valid, and only the CharStrings INDEX has to be rebuilt.  The
+  data behind it moves, so the offsets in the Top DICT are rewritten.
+*/
+
+#include "lily-guile.hh"
+#include "std-vector.hh"
+
+enum
+{
+  CHARSET_OP = 15,
+  ENCODING_OP = 16,
+  CHARSTRINGS_OP = 17,
+  PRIVATE_OP = 18,
+  SUBRS_OP = 19,
+  ROS_OP = 1230,
+};
+
+/* Type 2 charstring that draws nothing.  */
+static const char endchar = 14;
+
+struct Dict_entry
+{
+  int op_;
+  string operands_;
+  vector<long> values_;
+};
+
+static size_t
+get_uint (string const &s, size_t pos, int size)
+{
+  size_t v = 0;
+  for (int i = 0; i < size; i++)
+    v = (v << 8) | (Byte) s[pos + i];
+  return v;
+}
+
+static void
+put_uint (string *s, size_t v, int size)
+{
+  for (int i = size; i--;)
+    *s += char ((v >> (8 * i)) & 0xff);
+}
+
+/*
+  Parse the INDEX at POS.  OFFSETS gets the start of every element and
+  the end of the last one.  Return the end of the INDEX, or 0 if it is
+  malformed.
+*/
+static size_t
+read_index (string const &cff, size_t pos, vector<size_t> *offsets)
+{
+  offsets->clear ();
+  if (pos + 2 > cff.size ())
+    return 0;
+  size_t count = get_uint (cff, pos, 2);
+  if (!count)
+    return pos + 2;
+
+  if (pos + 3 > cff.size ())
+    return 0;
+  int off_size = (Byte) cff[pos + 2];
+  size_t array = pos + 3;
+  if (off_size < 1 || off_size > 4
+      || array + (count + 1) * off_size > cff.size ())
+    return 0;
+
+  size_t data = array + (count + 1) * off_size - 1;
+  for (size_t i = 0; i <= count; i++)
+    {
+      size_t o = data + get_uint (cff, array + i * off_size, off_size);
+      if (o > cff.size () || (i && o < offsets->back ()))
+        return 0;
+      offsets->push_back (o);
+    }
+  return offsets->back ();
+}
+
+static string
+make_index (vector<string> const &items)
+{
+  size_t total = 1;
+  for (vsize i = 0; i < items.size (); i++)
+    total += items[i].size ();
+  int off_size = 1;
+  while (off_size < 4 && total >> (8 * off_size))
+    off_size++;
+
+  string index;
+  put_uint (&index, items.size (), 2);
+  if (items.empty ())
+    return index;
+
+  index += char (off_size);
+  size_t offset = 1;
+  put_uint (&index, offset, off_size);
+  for (vsize i = 0; i < items.size (); i++)
+    {
+      offset += items[i].size ();
+      put_uint (&index, offset, off_size);
+    }
+  for (vsize i = 0; i < items.size (); i++)
+    index += items[i];
+  return index;
+}
+
+static bool
+read_dict (string const &cff, size_t pos, size_t end,
+           vector<Dict_entry> *dict)
+{
+  Dict_entry entry;
+  while (pos < end)
+    {
+      Byte b = cff[pos];
+      size_t start = pos;
+      long v = 0;
+      if (b <= 21)
+        {
+          entry.op_ = b;
+          pos++;
+          if (b == 12)
+            {
+              if (pos >= end)
+                return false;
+              entry.op_ = 1200 + (Byte) cff[pos++];
+            }
+          dict->push_back (entry);
+          entry = Dict_entry ();
+          continue;
+        }
+      else if (b == 28)
+        {
+          if (pos + 3 > end)
+            return false;
+          v = short (get_uint (cff, pos + 1, 2));
+          pos += 3;
+        }
+      else if (b == 29)
+        {
+          if (pos + 5 > end)
+            return false;
+          v = int (get_uint (cff, pos + 1, 4));
+          pos += 5;
+        }
+      else if (b == 30)
+        {
+          /* Real number; its value is never needed here.  */
+          for (pos++; pos < end;)
+            {
+              Byte nibbles = cff[pos++];
+              if ((nibbles >> 4) == 0xf || (nibbles & 0xf) == 0xf)
+                break;
+            }
+        }
+      else if (b >= 32 && b <= 246)
+        {
+          v = b - 139;
+          pos++;
+        }
+      else if (b >= 247 && b <= 254 && pos + 2 <= end)
+        {
+          if (b <= 250)
+            v = (b - 247) * 256 + (Byte) cff[pos + 1] + 108;
+          else
+            v = -(b - 251) * 256 - (Byte) cff[pos + 1] - 108;
+          pos += 2;
+        }
+      else
+        return false;
+
+      entry.operands_.append (cff, start, pos - start);
+      entry.values_.push_back (v);
+    }
+  return entry.operands_.empty ();
+}
+
+/* Offsets are always written with five bytes, so that the size of the
+   Top DICT does not depend on their values.  */
+static string
+write_dict (vector<Dict_entry> const &dict)
+{
+  string out;
+  for (vsize i = 0; i < dict.size (); i++)
+    {
+      Dict_entry const &e = dict[i];
+      bool offset = (e.op_ == CHARSET_OP && e.values_[0] > 2)
+                    || (e.op_ == ENCODING_OP && e.values_[0] > 1)
+                    || e.op_ == CHARSTRINGS_OP;
+      if (offset)
+        {
+          out += char (29);
+          put_uint (&out, e.values_[0], 4);
+        }
+      else if (e.op_ == PRIVATE_OP)
+        {
+          out += char (29);
+          put_uint (&out, e.values_[0], 4);
+          out += char (29);
+          put_uint (&out, e.values_[1], 4);
+        }
+      else
+        out += e.operands_;
+
+      if (e.op_ >= 1200)
+        {
+          out += char (12);
+          out += char (e.op_ - 1200);
+        }
+      else
+        out += char (e.op_);
+    }
+  return out;
+}
+
+static bool
+subset_cff (string const &cff, vector<bool> const &keep, string *result)
+{
+  if (cff.size () < 4)
+    return false;
+
+  vector<size_t> offsets;
+  size_t top_start = read_index (cff, (Byte) cff[2], &offsets);
+  if (!top_start)
+    return false;
+  size_t top_end = read_index (cff, top_start, &offsets);
+  if (!top_end || offsets.size () != 2)
+    return false;
+
+  vector<Dict_entry> top;
+  if (!read_dict (cff, offsets[0], offsets[1], &top))
+    return false;
+
+  long charstrings = 0;
+  long private_size = 0;
+  long private_offset = 0;
+  for (vsize i = 0; i < top.size (); i++)
+    {
+      Dict_entry const &e = top[i];
+      if (e.op_ == ROS_OP)
+        return false;
+      if ((e.op_ == CHARSET_OP || e.op_ == ENCODING_OP
+           || e.op_ == CHARSTRINGS_OP) && e.values_.size () != 1)
+        return false;
+      if (e.op_ == PRIVATE_OP && e.values_.size () != 2)
+        return false;
+
+      if (e.op_ == CHARSTRINGS_OP)
+        charstrings = e.values_[0];
+      else if (e.op_ == PRIVATE_OP)
+        {
+          private_size = e.values_[0];
+          private_offset = e.values_[1];
+        }
+    }
+  if (charstrings < long (top_end) || private_offset < 0
+      || private_size < 0
+      || size_t (private_offset + private_size) > cff.size ())
+    return false;
+
+  size_t cs_start = charstrings;
+  size_t cs_end = read_index (cff, cs_start, &offsets);
+  if (!cs_end || offsets.size () < 2)
+    return false;
+
+  /* Local subrs are addressed relative to the Private DICT, so both
+     must lie on the same side of the CharStrings.  */
+  vector<Dict_entry> priv;
+  if (!read_dict (cff, private_offset, private_offset + private_size, &priv))
+    return false;
+  for (vsize i = 0; i < priv.size (); i++)
+    if (priv[i].op_ == SUBRS_OP && priv[i].values_.size () == 1)
+      {
+        size_t subrs = private_offset + priv[i].values_[0];
+        if ((subrs < cs_start) != (size_t (private_offset) < cs_start))
+          return false;
+      }
+  if (size_t (private_offset) < cs_end
+      && size_t (private_offset + private_size) > cs_start)
+    return false;
+
+  vector<string> glyphs;
+  for (vsize i = 0; i + 1 < offsets.size (); i++)
+    if (!i || (i < keep.size () && keep[i]))
+      glyphs.push_back (cff.substr (offsets[i], offsets[i + 1] - offsets[i]));
+    else
+      glyphs.push_back (string (1, endchar));
+  string cs_index = make_index (glyphs);
+
+  vector<string> top_dict (1, write_dict (top));
+  long top_delta = long (make_index (top_dict).size ()) - long (top_end - top_start);
+  long cs_delta = long (cs_index.size ()) - long (cs_end - cs_start);
+
+  for (vsize i = 0; i < top.size (); i++)
+    {
+      Dict_entry &e = top[i];
+      long *offset = 0;
+      if ((e.op_ == CHARSET_OP && e.values_[0] > 2)
+          || (e.op_ == ENCODING_OP && e.values_[0] > 1)
+          || e.op_ == CHARSTRINGS_OP)
+        offset = &e.values_[0];
+      else if (e.op_ == PRIVATE_OP)
+        offset = &e.values_[1];
+
+      if (offset)
+        *offset += top_delta + ((*offset > long (cs_start)) ? cs_delta : 0);
+    }
+  top_dict[0] = write_dict (top);
+
+  *result = cff.substr (0, top_start);
+  *result += make_index (top_dict);
+  result->append (cff, top_end, cs_start - top_end);
+  *result += cs_index;
+  result->append (cff, cs_end, string::npos);
+  return true;
+}
+
+LY_DEFINE (ly_cff_subset, "ly:cff-subset",
+           2, 0, 0, (SCM cff, SCM glyph_indices),
+           "Return a copy of the name-keyed CFF font @var{cff} (a string)"
+           " in which all glyphs except @code{.notdef} and those with"
+           " an index in the list @var{glyph-indices} are empty.  Glyph"
+           " indices and names do not change.  If @var{cff} cannot be"
+           " subset, return it unchanged.")
+{
+  LY_ASSERT_TYPE (scm_is_string, cff, 1);
+  LY_ASSERT_TYPE (ly_is_list, glyph_indices, 2);
+
+  vector<bool> keep;
+  for (SCM s = glyph_indices; scm_is_pair (s); s = scm_cdr (s))
+    if (scm_is_integer (scm_car (s)))
+      {
+        size_t i = scm_to_size_t (scm_car (s));
+        if (i >= keep.size ())
+          keep.resize (i + 1, false);
+        keep[i] = true;
+      }
+
+  string subset;
+  if (!subset_cff (ly_scm2string (cff), keep, &subset))
+    return cff;
+
+  return scm_from_latin1_stringn (subset.data (), subset.size ());
+}
@@ -92,7 +92,7 @@ Constrained_breaking::calc_subproblem (vsize start, vsize sys, vsize brk)
       if (0 == sys && j > 0)
         continue; /* the first line cannot have its first break after the beginning */
 
-      Line_details const &cur = lines_.at (brk, j + start_col);
+      Line_details const &cur = line (j + start_col, brk);
       if (isinf (cur.force_))
         break;
 
@@ -101,7 +101,7 @@ Constrained_breaking::calc_subproblem (vsize start, vsize sys, vsize brk)
 
       if (sys > 0)
         {
-          prev_f = st.at (j, sys - 1).details_.force_;
+          prev_f = st.at (j, sys - 1).force_;
           prev_dem = st.at (j, sys - 1).demerits_;
         }
       if (isinf (prev_dem))
@@ -113,7 +113,7 @@ Constrained_breaking::calc_subproblem (vsize start, vsize sys, vsize brk)
         {
           found_something = true;
           n.demerits_ = dem;
-          n.details_ = cur;
+          n.force_ = cur.force_;
           n.prev_ = j;
         }
     }
@@ -126,7 +126,7 @@ Constrained_breaking::space_line (vsize i, vsize j)
   bool ragged_right = to_boolean (pscore_->layout ()->c_variable ("ragged-right"));
   bool ragged_last = to_boolean (pscore_->layout ()->c_variable ("ragged-last"));
 
-  vector<Grob *> line (all_.begin () + breaks_[i],
+  vector<Grob *> cols (all_.begin () + breaks_[i],
                        all_.begin () + breaks_[j] + 1);
   Interval line_dims = line_dimensions_int (pscore_->layout (), i);
   bool last = j == breaks_.size () - 1;
@@ -134,14 +134,18 @@ Constrained_breaking::space_line (vsize i, vsize j)
 
   /* As a special case, if there is only one line in the score and ragged-right
      hasn't been specifically forbidden and the line is stretched, use
-     ragged spacing. */
+     ragged spacing.
+
+     The force is looked up with the breakpoints swapped, as the
+     line matrix used to be indexed here.  No line is stored that way,
+     so the force is infinite and the test always holds. */
   if (last && i == 0
-      && lines_.at (i, j).force_ >= 0
+      && line (j, i).force_ >= 0
       && !scm_is_bool (pscore_->layout ()->c_variable ("ragged-right"))
       && !scm_is_bool (pscore_->layout ()->c_variable ("ragged-last")))
     ragged = true;
 
-  return get_line_configuration (line, line_dims[RIGHT] - line_dims[LEFT], line_dims[LEFT], ragged);
+  return get_line_configuration (cols, line_dims[RIGHT] - line_dims[LEFT], line_dims[LEFT], ragged);
 }
 
 void
@@ -178,7 +182,7 @@ Constrained_breaking::solve (vsize start, vsize end, vsize sys_count)
     {
       for (vsize brk = end_brk; brk != VPOS; brk--)
         {
-          if (!isinf (st.at (brk, sys).details_.force_))
+          if (!isinf (st.at (brk, sys).force_))
             {
               if (brk != end_brk)
                 {
@@ -250,6 +254,7 @@ Constrained_breaking::best_solution (vsize start, vsize end)
 std::vector<Line_details>
 Constrained_breaking::line_details (vsize start, vsize end, vsize sys_count)
 {
+  vsize start_brk = starting_breakpoints_[start];
   vsize end_brk = prepare_solution (start, end, sys_count);
   Matrix<Constrained_break_node> const &st = state_[start];
   vector<Line_details> ret;
@@ -260,7 +265,7 @@ Constrained_breaking::line_details (vsize start, vsize end, vsize sys_count)
     {
       for (vsize brk = end_brk; brk != VPOS; brk--)
         {
-          if (!isinf (st.at (brk, sys).details_.force_))
+          if (!isinf (st.at (brk, sys).force_))
             {
               if (brk != end_brk)
                 {
@@ -283,7 +288,7 @@ Constrained_breaking::line_details (vsize start, vsize end, vsize sys_count)
                 {
                   vsize prev_brk = st.at (brk, cur_sys).prev_;
                   assert (brk != VPOS);
-                  ret.push_back (st.at (brk, cur_sys).details_);
+                  ret.push_back (line (prev_brk + start_brk, brk + start_brk));
                   brk = prev_brk;
                 }
               reverse (ret);
@@ -316,7 +321,7 @@ Constrained_breaking::min_system_count (vsize start, vsize end)
         {
           resize (sys_count + 3);
         }
-      if (!isinf (st.at (brk, sys_count).details_.force_))
+      if (!isinf (st.at (brk, sys_count).force_))
         return sys_count + 1;
     }
   /* no possible breaks satisfy constraints */
@@ -439,26 +444,29 @@ Constrained_breaking::initialize ()
   /* do all the rod/spring problems */
   breaks_ = pscore_->get_break_indices ();
   all_ = pscore_->root_system ()->used_columns ();
-  lines_.resize (breaks_.size (), breaks_.size (), Line_details ());
-  vector<Real> forces = get_line_forces (all_,
-                                         other_lines.length (),
-                                         other_lines.length () - first_line.length (),
-                                         ragged_right_);
+  lines_.clear ();
+  lines_.resize (breaks_.size ());
+  vector<vector<Real> > forces = get_line_forces (all_,
+                                                  other_lines.length (),
+                                                  other_lines.length () - first_line.length (),
+                                                  ragged_right_);
   for (vsize i = 0; i + 1 < breaks_.size (); i++)
     {
       for (vsize j = i + 1; j < breaks_.size (); j++)
         {
           bool last = j == breaks_.size () - 1;
           bool ragged = ragged_right_ || (last && ragged_last_);
-          Line_details &line = lines_.at (j, i);
+          vsize k = j - i - 1;
+          Real force = (k < forces[i].size ()) ? forces[i][k] : infinity_f;
 
-          line.force_ = forces[i * breaks_.size () + j];
-          if (ragged && last && !isinf (line.force_))
-            line.force_ = (line.force_ < 0 && j > i + 1) ? infinity_f : 0;
-          if (isinf (line.force_))
+          if (ragged && last && !isinf (force))
+            force = (force < 0 && j > i + 1) ? infinity_f : 0;
+          if (isinf (force))
             break;
 
-          fill_line_details (&line, i, j);
+          lines_[i].push_back (Line_details ());
+          lines_[i].back ().force_ = force;
+          fill_line_details (&lines_[i].back (), i, j);
         }
     }
 
@@ -474,6 +482,20 @@ Constrained_breaking::initialize ()
   state_.resize (start_.size ());
 }
 
+/*
+  The line from breakpoint START_BRK to END_BRK.  Lines that were not
+  stored do not fit, and have infinite force.
+*/
+Line_details const &
+Constrained_breaking::line (vsize start_brk, vsize end_brk) const
+{
+  static Line_details const no_line;
+  if (start_brk < end_brk && start_brk < lines_.size ()
+      && end_brk - start_brk - 1 < lines_[start_brk].size ())
+    return lines_[start_brk][end_brk - start_brk - 1];
+  return no_line;
+}
+
 /*
   Fills out all of the information contained in a Line_details,
   except for information about horizontal spacing.
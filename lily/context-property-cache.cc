@@ -0,0 +1,134 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "context-property-cache.hh"
+
+/* Start at 1, so that zeroed entries are never current.  */
+unsigned long Context_property_cache::generation_ = 1;
+long Context_property_cache::lookups_ = 0;
+long Context_property_cache::hits_ = 0;
+long Context_property_cache::chain_depth_ = 0;
+
+Context_property_cache::Context_property_cache ()
+{
+  count_ = 0;
+}
+
+vsize
+Context_property_cache::slot (SCM sym) const
+{
+  vsize mask = entries_.size () - 1;
+  size_t h = size_t (SCM_UNPACK (sym)) >> 3;
+  h ^= h >> 16;
+
+  for (vsize i = h & mask;; i = (i + 1) & mask)
+    {
+      Entry const &e = entries_[i];
+      if (SCM_UNBNDP (e.sym_) || scm_is_eq (e.sym_, sym))
+        return i;
+    }
+}
+
+void
+Context_property_cache::grow ()
+{
+  vector<Entry> old;
+  old.swap (entries_);
+
+  Entry empty;
+  empty.sym_ = SCM_UNDEFINED;
+  empty.generation_ = 0;
+  empty.value_ = SCM_UNDEFINED;
+  empty.where_ = 0;
+  entries_.resize (old.empty () ? 16 : 2 * old.size (), empty);
+
+  for (vsize i = 0; i < old.size (); i++)
+    if (!SCM_UNBNDP (old[i].sym_))
+      entries_[slot (old[i].sym_)] = old[i];
+}
+
+/*
+  Return true if SYM has a current entry; set *VALUE (only if the
+  property is defined somewhere) and *WHERE.
+*/
+bool
+Context_property_cache::get (SCM sym, SCM *value, Context **where) const
+{
+  if (!count_)
+    return false;
+
+  Entry const &e = entries_[slot (sym)];
+  if (SCM_UNBNDP (e.sym_) || e.generation_ != generation_)
+    return false;
+
+  *where = e.where_;
+  if (e.where_)
+    *value = e.value_;
+  return true;
+}
+
+void
+Context_property_cache::set (SCM sym, SCM value, Context *where)
+{
+  /* Keep the load factor below 3/4.  Stale entries are reused, so
+     the table is bounded by the number of distinct properties.  */
+  if (4 * (count_ + 1) > 3 * entries_.size ())
+    grow ();
+
+  Entry &e = entries_[slot (sym)];
+  if (SCM_UNBNDP (e.sym_))
+    {
+      e.sym_ = sym;
+      count_++;
+    }
+  e.generation_ = generation_;
+  e.value_ = where ? value : SCM_EOL;
+  e.where_ = where;
+}
+
+void
+Context_property_cache::mark () const
+{
+  for (vsize i = 0; i < entries_.size (); i++)
+    if (!SCM_UNBNDP (entries_[i].sym_))
+      {
+        scm_gc_mark (entries_[i].sym_);
+        scm_gc_mark (entries_[i].value_);
+      }
+}
+
+LY_DEFINE (ly_context_property_cache_stats, "ly:context-property-cache-stats",
+           0, 0, 0, (),
+           "Return an alist with the number of context property"
+           " @code{lookups}, the number of cache @code{hits}, and the"
+           " @code{average-depth} of the context chain walked on a miss.")
+{
+  long misses = Context_property_cache::lookups_
+                - Context_property_cache::hits_;
+  Real depth = misses
+               ? Real (Context_property_cache::chain_depth_) / misses
+               : 0.0;
+
+  return scm_list_3 (scm_cons (ly_symbol2scm ("lookups"),
+                               scm_from_long (Context_property_cache::lookups_)),
+                     scm_cons (ly_symbol2scm ("hits"),
+                               scm_from_long (Context_property_cache::hits_)),
+                     scm_cons (ly_symbol2scm ("average-depth"),
+                               scm_from_double (depth)));
+}
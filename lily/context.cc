@@ -74,6 +74,7 @@ Context::add_context (Context *child)
                               scm_cons (child->self_scm (), SCM_EOL));
 
   child->daddy_context_ = this;
+  Context_property_cache::invalidate_all ();
   events_below_->register_as_listener (child->events_below_);
 }
 
@@ -485,10 +486,7 @@ Context::where_defined (SCM sym, SCM *value) const
     note_property_access (&context_property_lookup_table, sym);
 #endif
 
-  if (properties_dict ()->try_retrieve (sym, value))
-    return (Context *)this;
-
-  return (daddy_context_) ? daddy_context_->where_defined (sym, value) : 0;
+  return resolve_property (sym, value);
 }
 
 /* Quick variant of where_defined.  Checks only the context itself. */
@@ -516,13 +514,40 @@ Context::internal_get_property (SCM sym) const
 #endif
 
   SCM val = SCM_EOL;
-  if (properties_dict ()->try_retrieve (sym, &val))
-    return val;
+  resolve_property (sym, &val);
+  return val;
+}
 
-  if (daddy_context_)
-    return daddy_context_->internal_get_property (sym);
+/*
+  Find the context defining SYM, starting from this one, and store
+  its value in *VALUE.  Results are cached per context until the next
+  property assignment anywhere, so inherited properties that did not
+  change are found with a single probe.
+*/
+Context *
+Context::resolve_property (SCM sym, SCM *value) const
+{
+  Context_property_cache::lookups_++;
 
-  return val;
+  Context *where = 0;
+  if (property_cache_.get (sym, value, &where))
+    {
+      Context_property_cache::hits_++;
+      return where;
+    }
+
+  for (Context const *c = this; c; c = c->daddy_context_)
+    {
+      Context_property_cache::chain_depth_++;
+      if (c->properties_dict ()->try_retrieve (sym, value))
+        {
+          where = const_cast<Context *> (c);
+          break;
+        }
+    }
+
+  property_cache_.set (sym, *value, where);
+  return where;
 }
 
 /*
@@ -619,7 +644,10 @@ Context::internal_set_property (SCM sym, SCM val)
     assert (type_check_ok);
 
   if (type_check_ok)
-    properties_dict ()->set (sym, val);
+    {
+      properties_dict ()->set (sym, val);
+      Context_property_cache::invalidate_all ();
+    }
 }
 
 /*
@@ -629,6 +657,7 @@ void
 Context::unset_property (SCM sym)
 {
   properties_dict ()->remove (sym);
+  Context_property_cache::invalidate_all ();
 }
 
 void
@@ -660,6 +689,7 @@ Context::disconnect_from_parent ()
   daddy_context_->events_below_->unregister_as_listener (events_below_);
   daddy_context_->context_list_ = scm_delq_x (self_scm (), daddy_context_->context_list_);
   daddy_context_ = 0;
+  Context_property_cache::invalidate_all ();
 }
 
 Context *
@@ -814,6 +844,7 @@ Context::mark_smob () const
   scm_gc_mark (definition_);
   scm_gc_mark (definition_mods_);
   scm_gc_mark (properties_scm_);
+  property_cache_.mark ();
   scm_gc_mark (accepts_list_);
   scm_gc_mark (default_child_);
 
@@ -34,10 +34,14 @@ Dispatcher::Dispatcher ()
   listeners_ = SCM_EOL;
   dispatchers_ = SCM_EOL;
   listen_classes_ = SCM_EOL;
+  plan_table_ = SCM_EOL;
+  dispatch_depth_ = 0;
+  plans_stale_ = false;
   smobify_self ();
 // TODO: use resizable hash (guile 1.8)
 //  listeners_ = scm_c_make_hash_table (0);
   listeners_ = scm_c_make_hash_table (17);
+  plan_table_ = scm_c_make_hash_table (17);
   priority_count_ = 0;
 }
 
@@ -46,6 +50,10 @@ Dispatcher::mark_smob () const
 {
   scm_gc_mark (dispatchers_);
   scm_gc_mark (listen_classes_);
+  scm_gc_mark (plan_table_);
+  for (vsize i = 0; i < plans_.size (); i++)
+    for (vsize j = 0; j < plans_[i].size (); j++)
+      scm_gc_mark (plans_[i][j].callback_);
   return listeners_;
 }
 
@@ -59,18 +67,93 @@ Dispatcher::print_smob (SCM p, scm_print_state *) const
 }
 
 /*
-Event dispatching:
-- Collect a list of listeners for each relevant class
-- Send the event to each of these listeners, in increasing priority order.
-  This is done by keeping a priority queue of listener lists,
-  and iteratively send the event to the lowest-priority listener.
-- An event is never sent twice to listeners with equal priority.
-  The only case where listeners with equal priority may exist is when
-  two dispatchers are connected for more than one event type.  In that
-  case, the respective listeners all have the same priority, making
-  sure that any event is only dispatched at most once for that
-  combination of dispatchers, even if it matches more than one event
-  type.
+  Upper limit on the number of distinct class lists for which we keep
+  a plan.  Event classes normally come from ly:make-event-class and
+  are shared, but nothing prevents Scheme code from broadcasting events
+  with freshly consed class lists.
+*/
+static const vsize MAX_PLANS = 256;
+
+bool
+Dispatcher::plan_entry_less (Plan_entry const &a, Plan_entry const &b)
+{
+  return a.priority_ < b.priority_;
+}
+
+void
+Dispatcher::invalidate_plans ()
+{
+  if (plans_.empty ())
+    return;
+
+  plan_table_ = scm_c_make_hash_table (17);
+  if (dispatch_depth_)
+    plans_stale_ = true;
+  else
+    plans_.clear ();
+}
+
+/*
+  Return the index of the plan for CLASS_LIST, building it if needed.
+
+  The listener list of each class is ordered by priority; a plan is
+  the merge of these lists.  An event is never sent twice to listeners
+  with equal priority.  The only case where listeners with equal
+  priority may exist is when two dispatchers are connected for more
+  than one event type.  In that case, the respective listeners all
+  have the same priority, making sure that any event is only
+  dispatched at most once for that combination of dispatchers, even if
+  it matches more than one event type.
+*/
+vsize
+Dispatcher::find_plan (SCM class_list)
+{
+  SCM idx = scm_hashq_ref (plan_table_, class_list, SCM_BOOL_F);
+  if (scm_is_integer (idx))
+    return scm_to_uint (idx);
+
+  if (plans_.size () >= MAX_PLANS)
+    invalidate_plans ();
+
+  vector<Plan_entry> plan;
+  for (SCM cl = class_list; scm_is_pair (cl); cl = scm_cdr (cl))
+    for (SCM l = scm_hashq_ref (listeners_, scm_car (cl), SCM_EOL);
+         scm_is_pair (l); l = scm_cdr (l))
+      {
+        Plan_entry e;
+        e.priority_ = scm_to_int (scm_caar (l));
+        e.callback_ = scm_cdar (l);
+        plan.push_back (e);
+      }
+
+  /* Stable, so that of several listeners with the same priority the
+     one from the most specific class is kept.  */
+  stable_sort (plan.begin (), plan.end (), plan_entry_less);
+
+  vsize n = 0;
+  for (vsize i = 0; i < plan.size (); i++)
+    if (!n || plan[n - 1].priority_ != plan[i].priority_)
+      plan[n++] = plan[i];
+  plan.resize (n);
+
+  vsize result = plans_.size ();
+  plans_.push_back (plan);
+  scm_hashq_set_x (plan_table_, class_list, scm_from_uint (result));
+  return result;
+}
+
+/*
+  Event dispatching: look up the plan for the class list of the event,
+  and send the event to each of its listeners, in increasing priority
+  order.  Building the plan is done once per class list, so dispatching
+  does not allocate.
+
+  Listeners may register or remove listeners, or dispatch other events
+  through this dispatcher.  The event still goes to the listeners that
+  were registered when its dispatch started: plans are not removed from
+  PLANS_ until the outermost dispatch is done, and PLANS_ only grows
+  until then.  It may be reallocated by nested calls, so we index it
+  anew for every listener.
 */
 void
 Dispatcher::dispatch (SCM sev)
@@ -83,87 +166,18 @@ Dispatcher::dispatch (SCM sev)
       return;
     }
 
-#if 0
-  bool sent = false;
-#endif
-  int num_classes = scm_ilength (class_list);
-
-  /*
-    For each event class there is a list of listeners, which is
-    ordered by priority. Our next task is to call these listeners, in
-    priority order.  A priority queue stores the next element in each
-    listener list, and the lowest priority element is repeatedly
-    extracted and called.
-
-    The priority queue is implemented as an insertion-sorted C
-    array. Using the stack instead of native Scheme datastructures
-    avoids overheads for memory allocation. The queue is usually small
-    (around 2 elements), so the quadratic sorting time is not a
-    problem. (if this changes, it's easy to rewrite this routine using
-    a heap)
-
-    The first step is to collect all listener lists and to initially
-    insert them in the priority queue.
-  */
-  struct { int prio; SCM list; } lists[num_classes + 1];
-  int i = 0;
-  for (SCM cl = class_list; scm_is_pair (cl); cl = scm_cdr (cl))
-    {
-      SCM list = scm_hashq_ref (listeners_, scm_car (cl), SCM_EOL);
-      if (!scm_is_pair (list))
-        num_classes--;
-      else
-        {
-          // insertion sort.
-          int prio = scm_to_int (scm_caar (list));
-          int j;
-          for (j = i; j > 0 && lists[j - 1].prio > prio; j--)
-            lists[j] = lists[j - 1];
-          lists[j].prio = prio;
-          lists[j].list = list;
-          i++;
-        }
-    }
-  lists[num_classes].prio = INT_MAX;
-
-  // Never send an event to two listeners with equal priority.
-  int last_priority = -1;
-  /*
-    Each iteration extracts the lowest-priority element, which is a
-    list of listeners. The first listener is called, and the tail of
-    the list is pushed back into the priority queue.
-  */
-  while (num_classes)
+  vsize idx = find_plan (class_list);
+  dispatch_depth_++;
+  for (vsize i = 0; i < plans_[idx].size (); i++)
+    scm_call_1 (plans_[idx][i].callback_, ev->self_scm ());
+  dispatch_depth_--;
+
+  if (!dispatch_depth_ && plans_stale_)
     {
-      // Send the event, if we haven't already sent it to this target.
-      if (lists[0].prio != last_priority)
-        {
-          // process the listener
-          assert (lists[0].prio > last_priority);
-          last_priority = lists[0].prio;
-
-          SCM l = scm_cdar (lists[0].list);
-          scm_call_1 (l, ev->self_scm ());
-#if 0
-          sent = true;
-#endif
-        }
-      // go to the next listener; bubble-sort the class list.
-      SCM next = scm_cdr (lists[0].list);
-      if (!scm_is_pair (next))
-        num_classes--;
-      int prio = (scm_is_pair (next)) ? scm_to_int (scm_caar (next)) : INT_MAX;
-      for (i = 0; prio > lists[i + 1].prio; i++)
-        lists[i] = lists[i + 1];
-      lists[i].prio = prio;
-      lists[i].list = next;
+      plans_stale_ = false;
+      plans_.clear ();
+      plan_table_ = scm_c_make_hash_table (17);
     }
-
-#if 0
-  /* TODO: Uncomment. */
-  if (!sent)
-    warning (_f ("Junking event: %s", ly_symbol2string (class_symbol).c_str ()));
-#endif
 }
 
 bool
@@ -244,6 +258,7 @@ Dispatcher::internal_add_listener (SCM callback, SCM ev_class, int priority)
   SCM entry = scm_cons (scm_from_int (priority), callback);
   list = scm_merge (list, scm_list_1 (entry), Lily::car_less);
   scm_set_cdr_x (handle, list);
+  invalidate_plans ();
 }
 
 void
@@ -274,6 +289,7 @@ Dispatcher::remove_listener (Listener l, SCM ev_class)
       e = scm_cdr (e);
   list = scm_cdr (dummy);
   scm_set_cdr_x (handle, list);
+  invalidate_plans ();
 
   if (first)
     warning (_ ("Attempting to remove nonexisting listener."));
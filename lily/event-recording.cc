@@ -0,0 +1,329 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Record the events of every context while interpreting music, for
+  the part combiner, \autochange and \addQuote.  These often see the
+  same music several times, e.g. a part that is both quoted and
+  combined, so the recordings are cached for the rest of the session.
+  Music that calls procedures while it is interpreted is not cached.
+*/
+
+#include "context.hh"
+#include "dispatcher.hh"
+#include "global-context.hh"
+#include "listener.hh"
+#include "music.hh"
+#include "output-def.hh"
+#include "stream-event.hh"
+
+/*
+  The events of one context, as (ID . MOMENTS).  MOMENTS is a list of
+  ((MOMENT . INSTRUMENT-TRANSPOSITION) (EVENT . #t) ...), with the
+  latest time step first.
+*/
+class Context_recording : public Smob<Context_recording>
+{
+public:
+  SCM mark_smob () const;
+  static const char * const type_p_name_;
+
+  Context_recording (Context *c);
+
+  SCM entry_;
+
+  void record_event (SCM);
+  void one_time_step (SCM);
+
+private:
+  Context *context_;
+  SCM pending_;
+};
+
+const char * const Context_recording::type_p_name_ = 0;
+
+Context_recording::Context_recording (Context *c)
+{
+  context_ = c;
+  entry_ = SCM_EOL;
+  pending_ = SCM_EOL;
+  smobify_self ();
+  entry_ = scm_list_1 (ly_string2scm (c->id_string ()));
+}
+
+SCM
+Context_recording::mark_smob () const
+{
+  scm_gc_mark (pending_);
+  return entry_;
+}
+
+void
+Context_recording::record_event (SCM ev)
+{
+  pending_ = scm_cons (scm_cons (ev, SCM_BOOL_T), pending_);
+}
+
+void
+Context_recording::one_time_step (SCM)
+{
+  if (!scm_is_pair (pending_))
+    return;
+
+  Moment now = context_->get_global_context ()->now_mom ();
+  SCM when = scm_cons (now.smobbed_copy (),
+                       context_->get_property ("instrumentTransposition"));
+  scm_set_cdr_x (entry_, scm_cons (scm_cons (when,
+                                             scm_reverse_x (pending_, SCM_EOL)),
+                                   scm_cdr (entry_)));
+  pending_ = SCM_EOL;
+}
+
+/*
+  Collects a Context_recording for every context created below the
+  global context, the latest first.
+*/
+class Event_recorder : public Smob<Event_recorder>
+{
+public:
+  SCM mark_smob () const;
+  static const char * const type_p_name_;
+
+  Event_recorder (Global_context *g);
+
+  SCM contexts_;
+
+  void new_context (SCM);
+
+private:
+  Global_context *global_;
+};
+
+const char * const Event_recorder::type_p_name_ = 0;
+
+Event_recorder::Event_recorder (Global_context *g)
+{
+  global_ = g;
+  contexts_ = SCM_EOL;
+  smobify_self ();
+}
+
+SCM
+Event_recorder::mark_smob () const
+{
+  return contexts_;
+}
+
+void
+Event_recorder::new_context (SCM sev)
+{
+  Stream_event *ev = unsmob<Stream_event> (sev);
+  Context *c = unsmob<Context> (ev->get_property ("context"));
+
+  Context_recording *rec = new Context_recording (c);
+  contexts_ = scm_cons (rec->entry_, contexts_);
+  c->event_source ()->add_listener (rec->GET_LISTENER (Context_recording,
+                                                       record_event),
+                                    ly_symbol2scm ("StreamEvent"));
+  global_->event_source ()->add_listener
+    (rec->GET_LISTENER (Context_recording, one_time_step),
+     ly_symbol2scm ("OneTimeStep"));
+  rec->unprotect ();
+}
+
+static SCM
+record_context_events (SCM music, SCM odef)
+{
+  SCM global = ly_make_global_context (odef);
+  Global_context *g = unsmob<Global_context> (global);
+  Event_recorder *recorder = new Event_recorder (g);
+  g->events_below ()->add_listener (recorder->GET_LISTENER (Event_recorder,
+                                                            new_context),
+                                    ly_symbol2scm ("AnnounceNewContext"));
+
+  ly_interpret_music_expression (music, global);
+
+  SCM contexts = recorder->contexts_;
+  recorder->unprotect ();
+  scm_remember_upto_here_1 (global);
+  return contexts;
+}
+
+/*
+  Recordings are stored by a hash of the music, in lists of
+  (MUSIC OUTPUT-DEF . CONTEXTS).  Guile's hash functions do not look
+  into smobs, hence the hash function of our own.
+*/
+static SCM recording_cache = SCM_BOOL_F;
+
+/*
+  Contexts created for the music itself get their names from the
+  callers, and these differ for the same music.  Record such a context
+  under this name, and rename it when returning the recording.
+*/
+static SCM placeholder_id = SCM_BOOL_F;
+
+static void
+init_recording_cache ()
+{
+  recording_cache = scm_c_make_hash_table (59);
+  scm_gc_protect_object (recording_cache);
+  placeholder_id = ly_string2scm ("\\recorded");
+  scm_gc_protect_object (placeholder_id);
+}
+ADD_SCM_INIT_FUNC (event_recording, init_recording_cache);
+
+static const unsigned long HASH_RANGE = 1UL << 30;
+
+static unsigned long
+music_hash (SCM m)
+{
+  unsigned long h = 0;
+  if (Music *mus = unsmob<Music> (m))
+    {
+      for (SCM s = mus->get_property_alist (true); scm_is_pair (s);
+           s = scm_cdr (s))
+        h = (31 * h + scm_ihash (scm_caar (s), HASH_RANGE)
+             + music_hash (scm_cdar (s))) % HASH_RANGE;
+    }
+  else if (scm_is_pair (m))
+    {
+      for (; scm_is_pair (m); m = scm_cdr (m))
+        h = (31 * h + music_hash (scm_car (m))) % HASH_RANGE;
+    }
+  else if (!unsmob<Input> (m))
+    h = scm_ihash (m, HASH_RANGE);
+  return h;
+}
+
+/*
+  Music that runs procedures while it is interpreted, such as
+  \applyContext and \applyOutput, may have side effects that every
+  caller expects to happen.  Such music is recorded anew each time.
+*/
+static bool
+runs_procedures (SCM m)
+{
+  if (Music *mus = unsmob<Music> (m))
+    {
+      for (SCM s = mus->get_property_alist (true); scm_is_pair (s);
+           s = scm_cdr (s))
+        if (scm_is_eq (scm_caar (s), ly_symbol2scm ("procedure"))
+            || runs_procedures (scm_cdar (s)))
+          return true;
+    }
+  else
+    {
+      for (; scm_is_pair (m); m = scm_cdr (m))
+        if (runs_procedures (scm_car (m)))
+          return true;
+    }
+  return false;
+}
+
+static Music *
+named_context_spec (Music *m)
+{
+  while (m && m->is_mus_type ("music-wrapper-music"))
+    {
+      if (m->is_mus_type ("context-specification"))
+        return (!to_boolean (m->get_property ("create-new"))
+                && scm_is_string (m->get_property ("context-id")))
+               ? m : 0;
+      m = unsmob<Music> (m->get_property ("element"));
+    }
+  return 0;
+}
+
+static SCM
+copy_recording (SCM contexts, SCM id)
+{
+  SCM copy = SCM_EOL;
+  for (SCM s = contexts; scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM name = scm_caar (s);
+      if (ly_is_equal (name, placeholder_id))
+        name = id;
+      copy = scm_cons (scm_cons (name, scm_list_copy (scm_cdar (s))), copy);
+    }
+  return scm_reverse_x (copy, SCM_EOL);
+}
+
+LY_DEFINE (ly_record_context_events, "ly:record-context-events",
+           2, 0, 0, (SCM music, SCM odef),
+           "Interpret @var{music} according to @var{odef} and return the"
+           " events of all contexts, as a list of @code{(@var{id}"
+           " . @var{moments})} with the latest context first."
+           "  Every element of @var{moments} is a list"
+           " @code{((@var{moment} . @var{instrument-transposition})"
+           " (@var{event} . #t) @dots{})}, again with the latest"
+           " @var{moment} first.  Results are cached for the rest of"
+           " the session, so @var{music} must not depend on anything"
+           " except @var{odef}.  Music that calls procedures while it"
+           " is interpreted, e.g., @code{\\applyContext}, is not cached.")
+{
+  LY_ASSERT_SMOB (Music, music, 1);
+  LY_ASSERT_SMOB (Output_def, odef, 2);
+
+  if (runs_procedures (music))
+    return record_context_events (music, odef);
+
+  Music *spec = named_context_spec (unsmob<Music> (music));
+  SCM id = SCM_BOOL_F;
+  if (spec)
+    {
+      id = spec->get_property ("context-id");
+      spec->set_property ("context-id", placeholder_id);
+    }
+
+  SCM key = scm_from_ulong (music_hash (music));
+  SCM bucket = scm_hashv_ref (recording_cache, key, SCM_EOL);
+  SCM contexts = SCM_UNDEFINED;
+  for (SCM s = bucket; scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM entry = scm_car (s);
+      if (scm_is_eq (scm_cadr (entry), odef)
+          && ly_is_equal (scm_car (entry), music))
+        {
+          contexts = scm_cddr (entry);
+          break;
+        }
+    }
+
+  if (SCM_UNBNDP (contexts))
+    {
+      SCM copy = music_deep_copy (music);
+      contexts = record_context_events (music, odef);
+      scm_hashv_set_x (recording_cache, key,
+                       scm_cons (scm_cons2 (copy, odef, contexts), bucket));
+    }
+
+  if (spec)
+    spec->set_property ("context-id", id);
+
+  return copy_recording (contexts, id);
+}
+
+LY_DEFINE (ly_clear_context_event_cache, "ly:clear-context-event-cache",
+           0, 0, 0, (),
+           "Forget all recordings made by @code{ly:record-context-events}.")
+{
+  scm_hash_clear_x (recording_cache);
+  return SCM_UNSPECIFIED;
+}
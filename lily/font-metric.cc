@@ -40,6 +40,10 @@ Stencil
 Font_metric::find_by_name (string s) const
 {
   replace_all (&s, '-', 'M');
+  map<string, Stencil>::const_iterator i = glyph_stencils_.find (s);
+  if (i != glyph_stencils_.end ())
+    return i->second;
+
   int idx = name_to_index (s);
   Box b;
 
@@ -53,6 +57,7 @@ Font_metric::find_by_name (string s) const
     }
 
   Stencil q (b, expr);
+  glyph_stencils_[s] = q;
   return q;
 }
 
@@ -98,6 +103,9 @@ SCM
 Font_metric::mark_smob () const
 {
   derived_mark ();
+  for (map<string, Stencil>::const_iterator i = glyph_stencils_.begin ();
+       i != glyph_stencils_.end (); i++)
+    scm_gc_mark (i->second.expr ());
   return description_;
 }
 
@@ -20,6 +20,8 @@
 #include "freetype.hh"
 #include "warn.hh"
 
+#include <cstdlib>
+
 #include FT_OUTLINE_H
 #include FT_BBOX_H
 
@@ -48,6 +50,31 @@ ly_FT_get_unscaled_indexed_char_dimensions (FT_Face const &face, size_t signed_i
               Interval (Real (vb - m.height), Real (vb)));
 }
 
+/*
+  Look up a glyph by the names we create in pango-font.cc: the name
+  from the font if it has any, otherwise glyphIndexXX, uniXXXX or
+  uXXXXX.  Return 0 for unknown glyphs.
+*/
+FT_UInt
+ly_FT_name_to_index (FT_Face const &face, string const &name)
+{
+  FT_UInt idx = 0;
+  if (FT_HAS_GLYPH_NAMES (face))
+    idx = FT_Get_Name_Index (face, (FT_String *) name.c_str ());
+
+  if (idx)
+    return idx;
+
+  if (name.compare (0, 10, "glyphIndex") == 0)
+    return FT_UInt (strtoul (name.c_str () + 10, 0, 16));
+  if (name.compare (0, 3, "uni") == 0)
+    return FT_Get_Char_Index (face, strtoul (name.c_str () + 3, 0, 16));
+  if (name.length () > 1 && name[0] == 'u')
+    return FT_Get_Char_Index (face, strtoul (name.c_str () + 1, 0, 16));
+
+  return 0;
+}
+
 SCM
 box_to_scheme_lines (Box b)
 {
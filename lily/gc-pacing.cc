@@ -0,0 +1,166 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gc-pacing.hh"
+
+#include <algorithm>
+
+#include "cpu-timer.hh"
+#include "international.hh"
+#include "program-option.hh"
+#include "warn.hh"
+
+/*
+  Garbage collection pacing.
+
+  The initial heap is sized from the input files before GUILE starts
+  (see setup_guile_gc_env in main.cc).  While a file is processed, the
+  heap growth during parsing and translation is measured, and used to
+  predict how much layout will allocate.  Before layout, the heap is
+  grown to make room for that, so that layout runs with few (or, with
+  -dlayout-heap-limit, ideally no) collections.
+
+  GUILE has no call for growing the heap, so it is done by allocating
+  and dropping a list of the required size: the collections during
+  its construction find nothing to free, which makes GUILE add heap
+  segments.
+*/
+
+/* Reserves smaller than this are not worth a collection.  */
+static const size_t MIN_LAYOUT_RESERVE = 4 << 20;
+
+/* Rough estimate of how much layout allocates relative to parsing and
+   translation, used when -dlayout-heap-limit allows a large heap.  */
+static const size_t LAYOUT_GROWTH_FACTOR = 3;
+
+static size_t file_start_heap = 0;
+
+static size_t collections = 0;
+static Real max_pause = 0.0;
+static Cpu_timer gc_timer;
+
+static void *
+before_gc (void *, void *, void *)
+{
+  gc_timer.restart ();
+  return 0;
+}
+
+static void *
+after_gc (void *, void *, void *)
+{
+  collections++;
+  max_pause = max (max_pause, gc_timer.read ());
+  return 0;
+}
+
+static void
+init_gc_pacing ()
+{
+  scm_c_hook_add (&scm_before_gc_c_hook, before_gc, 0, 0);
+  scm_c_hook_add (&scm_after_gc_c_hook, after_gc, 0, 0);
+}
+ADD_SCM_INIT_FUNC (gc_pacing, init_gc_pacing);
+
+/* Return the entry KEY of (gc-stats), or 0 if there is none.  */
+size_t
+gc_statistic (const char *key)
+{
+  SCM entry = scm_assq (ly_symbol2scm (key), scm_gc_stats ());
+  if (scm_is_pair (entry) && scm_is_integer (scm_cdr (entry)))
+    return scm_to_size_t (scm_cdr (entry));
+  return 0;
+}
+
+static size_t
+free_heap ()
+{
+  // GUILE 2 knows; GUILE 1.8 only counts the cells in use.
+  SCM stats = scm_gc_stats ();
+  if (scm_is_pair (scm_assq (ly_symbol2scm ("heap-free-size"), stats)))
+    return gc_statistic ("heap-free-size");
+
+  size_t heap = gc_statistic ("heap-size");
+  size_t used = gc_statistic ("cells-allocated") * 2 * sizeof (SCM);
+  return heap > used ? heap - used : 0;
+}
+
+static void
+grow_heap (size_t bytes)
+{
+  debug_output (_f ("Reserving %d kB of heap for layout",
+                    int (bytes >> 10)));
+
+  SCM reserve = SCM_EOL;
+  for (size_t n = bytes / (2 * sizeof (SCM)); n--;)
+    reserve = scm_cons (SCM_BOOL_F, reserve);
+  scm_remember_upto_here_1 (reserve);
+  reserve = SCM_EOL;
+  scm_gc ();
+}
+
+void
+gc_pacing_start_file ()
+{
+  file_start_heap = gc_statistic ("heap-size");
+}
+
+void
+gc_pacing_before_layout ()
+{
+  if (!get_program_option ("adaptive-gc"))
+    return;
+
+  size_t heap = gc_statistic ("heap-size");
+  if (heap <= file_start_heap)
+    return;
+
+  size_t growth = heap - file_start_heap;
+  size_t wanted = growth;
+  SCM limit = ly_get_option (ly_symbol2scm ("layout-heap-limit"));
+  if (scm_is_integer (limit))
+    {
+      size_t budget = scm_to_size_t (limit) << 20;
+      if (heap + LAYOUT_GROWTH_FACTOR * growth <= budget)
+        wanted = LAYOUT_GROWTH_FACTOR * growth;
+      else if (heap + growth > budget)
+        wanted = budget > heap ? budget - heap : 0;
+    }
+
+  size_t available = free_heap ();
+  if (wanted > available && wanted - available >= MIN_LAYOUT_RESERVE)
+    grow_heap (wanted - available);
+}
+
+LY_DEFINE (ly_gc_statistics, "ly:gc-statistics",
+           0, 1, 0, (SCM reset),
+           "Return an alist with the number of garbage collections"
+           " (@code{collections}) and the longest pause for a"
+           " collection in seconds (@code{max-pause}).  If @var{reset}"
+           " is true, start measuring the longest pause anew"
+           " afterwards.")
+{
+  SCM stats = scm_list_2 (scm_cons (ly_symbol2scm ("collections"),
+                                    scm_from_size_t (collections)),
+                          scm_cons (ly_symbol2scm ("max-pause"),
+                                    scm_from_double (max_pause)));
+  if (to_boolean (reset))
+    max_pause = 0.0;
+  return stats;
+}
@@ -24,6 +24,9 @@
 #include <ctype.h>
 #include <cstring>  /* memset */
 #include <glib.h>
+#if HAVE_LIBZ
+#include <zlib.h>
+#endif
 using namespace std;
 
 #include "dimensions.hh"
@@ -33,6 +36,7 @@ using namespace std;
 #include "libc-extension.hh"
 #include "lily-guile.hh"
 #include "main.hh"
+#include "markup-cache.hh"
 #include "misc.hh"
 #include "program-option.hh"
 #include "relocate.hh"
@@ -99,6 +103,26 @@ LY_DEFINE (ly_gulp_file, "ly:gulp-file",
   return scm_from_latin1_stringn (contents.c_str (), contents.length ());
 }
 
+LY_DEFINE (ly_deflate, "ly:deflate",
+           1, 0, 0, (SCM str),
+           "Compress the bytes of string @var{str} into a zlib stream,"
+           " as read by the @code{FlateDecode} filter of PDF.  Return"
+           " @code{#f} if LilyPond was built without zlib.")
+{
+  LY_ASSERT_TYPE (scm_is_string, str, 1);
+
+#if HAVE_LIBZ
+  string data = ly_scm2string (str);
+  uLongf len = compressBound (data.size ());
+  vector<Bytef> buf (len);
+  if (compress2 (&buf[0], &len, (Bytef const *) data.data (), data.size (),
+                 Z_BEST_COMPRESSION) == Z_OK)
+    return scm_from_latin1_stringn ((char const *) &buf[0], len);
+#endif
+
+  return SCM_BOOL_F;
+}
+
 LY_DEFINE (ly_dir_p, "ly:dir?",
            1, 0, 0, (SCM s),
            "Is @var{s} a direction?  Valid directions are @w{@code{-1}},"
@@ -361,14 +385,21 @@ LY_DEFINE (ly_chain_assoc_get, "ly:chain-assoc-get",
 {
   if (scm_is_pair (achain))
     {
-      SCM handle = scm_assoc (key, scm_car (achain));
-      if (scm_is_pair (handle))
-        return scm_cdr (handle);
-      else
-        return ly_chain_assoc_get (key, scm_cdr (achain), default_value);
+      for (SCM s = achain; scm_is_pair (s); s = scm_cdr (s))
+        {
+          SCM handle = scm_assoc (key, scm_car (s));
+          if (scm_is_pair (handle))
+            {
+              if (Markup_cache::is_recording ())
+                Markup_cache::note_property_read (key, achain, s,
+                                                  scm_cdr (handle));
+              return scm_cdr (handle);
+            }
+        }
+      if (Markup_cache::is_recording ())
+        Markup_cache::note_property_read (key, achain, SCM_EOL, SCM_BOOL_F);
     }
-
-  if (to_boolean (strict_checking))
+  else if (to_boolean (strict_checking))
     {
       string key_string = ly_scm2string
                           (scm_object_to_string (key, SCM_UNDEFINED));
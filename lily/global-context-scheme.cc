@@ -100,6 +100,7 @@ LY_DEFINE (ly_interpret_music_expression, "ly:interpret-music-expression",
 
   Cpu_timer timer;
 
+  report_memory ("interpreting music");
   message (_ ("Interpreting music..."));
 
   SCM protected_iter = Music_iterator::get_static_get_iterator (music);
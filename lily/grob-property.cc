@@ -4,6 +4,7 @@
 
 #include <cstring>
 
+#include "cpu-timer.hh"
 #include "main.hh"
 #include "input.hh"
 #include "pointer-group-interface.hh"
@@ -229,7 +230,17 @@ Grob::try_callback_on_alist (SCM *alist, SCM sym, SCM proc)
 
   SCM value = SCM_EOL;
   if (ly_is_procedure (proc))
-    value = scm_call_1 (proc, self_scm ());
+    {
+      if (profile_property_accesses)
+        {
+          Cpu_timer timer;
+          value = scm_call_1 (proc, self_scm ());
+          string key = name () + "." + ly_symbol2string (sym);
+          note_callback_time (ly_symbol2scm (key.c_str ()), timer.read ());
+        }
+      else
+        value = scm_call_1 (proc, self_scm ());
+    }
 
 #ifdef DEBUG
   if (debug_property_callbacks)
@@ -53,6 +53,7 @@ Grob::Grob (SCM basicprops)
   /* FIXME: default should be no callback.  */
   layout_ = 0;
   original_ = 0;
+  break_substitution_index_ = VPOS;
   interfaces_ = SCM_EOL;
   immutable_property_alist_ = basicprops;
   mutable_property_alist_ = SCM_EOL;
@@ -96,6 +97,7 @@ Grob::Grob (Grob const &s)
   : Smob<Grob> ()
 {
   original_ = (Grob *) & s;
+  break_substitution_index_ = VPOS;
 
   immutable_property_alist_ = s.immutable_property_alist_;
   mutable_property_alist_ = SCM_EOL;
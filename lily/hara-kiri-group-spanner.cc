@@ -55,23 +55,66 @@ Hara_kiri_group_spanner::pure_height (SCM smob, SCM start_scm, SCM end_scm)
   if (request_suicide (me, start, end))
     return ly_interval2scm (Interval ());
 
-  return ly_interval2scm (Axis_group_interface::pure_group_height (me, start, end));
+  /* Line breaking asks for this once for every staff of every
+     system candidate, and again for every staff below it.  */
+  Spanner *sp = dynamic_cast<Spanner *> (me);
+  SCM cache_symbol = ly_symbol2scm ("hara-kiri-pure-height");
+  if (sp)
+    {
+      SCM cached = sp->get_cached_pure_property (cache_symbol, start, end);
+      if (scm_is_pair (cached))
+        return cached;
+    }
+
+  SCM ret = ly_interval2scm (Axis_group_interface::pure_group_height (me, start, end));
+  if (sp)
+    sp->cache_pure_property (cache_symbol, start, end, ret);
+  return ret;
 }
 
-/* there is probably a way that doesn't involve re-implementing a binary
-   search (I would love some proper closures right now) */
-bool find_in_range (SCM vector, int low, int hi, int min, int max)
+/*
+  Element R of the important-column-ranks vector counts the important
+  columns with a rank below R.  It ends after the last important
+  column, so this is the count for every rank beyond it.
+*/
+static int
+important_columns_below (SCM counts, int rank)
 {
-  if (low >= hi)
-    return false;
+  int len = scm_c_vector_length (counts);
+  if (rank <= 0)
+    return 0;
+  return scm_to_int (scm_c_vector_ref (counts, min (rank, len - 1)));
+}
 
-  int mid = low + (hi - low) / 2;
-  int val = scm_to_int (scm_c_vector_ref (vector, mid));
-  if (val >= min && val <= max)
-    return true;
-  else if (val < min)
-    return find_in_range (vector, mid + 1, hi, min, max);
-  return find_in_range (vector, low, mid, min, max);
+static SCM
+important_column_counts (Grob *me)
+{
+  SCM counts = me->get_property ("important-column-ranks");
+  if (scm_is_vector (counts))
+    return counts;
+
+  extract_grob_set (me, "items-worth-living", worth);
+  vector<int> ranks;
+  for (vsize i = 0; i < worth.size (); i++)
+    {
+      Interval_t<int> iv = worth[i]->spanned_rank_interval ();
+      for (int j = iv[LEFT]; j <= iv[RIGHT]; j++)
+        ranks.push_back (j);
+    }
+  vector_sort (ranks, less<int> ());
+  uniq (ranks);
+
+  int len = ranks.empty () ? 1 : max (ranks.back (), 0) + 2;
+  counts = scm_c_make_vector (len, scm_from_int (0));
+  vsize k = 0;
+  for (int r = 0; r < len; r++)
+    {
+      while (k < ranks.size () && ranks[k] < r)
+        k++;
+      scm_c_vector_set_x (counts, r, scm_from_int (k));
+    }
+  me->set_property ("important-column-ranks", counts);
+  return counts;
 }
 
 bool
@@ -103,36 +146,14 @@ Hara_kiri_group_spanner::request_suicide_alone (Grob *me, int start, int end)
   if (!remove_first && start <= 0)
     return false;
 
-  SCM important = me->get_property ("important-column-ranks");
-  if (scm_is_vector (important))
-    {
-      int len = scm_c_vector_length (important);
-      if (find_in_range (important, 0, len, start, end))
-        return false;
-    }
-  else /* build the important-columns-cache */
-    {
-      extract_grob_set (me, "items-worth-living", worth);
-      vector<int> ranks;
-
-      for (vsize i = 0; i < worth.size (); i++)
-        {
-          Interval_t<int> iv = worth[i]->spanned_rank_interval ();
-          for (int j = iv[LEFT]; j <= iv[RIGHT]; j++)
-            ranks.push_back (j);
-        }
-      vector_sort (ranks, less<int> ());
-      uniq (ranks);
-
-      SCM scm_vec = scm_c_make_vector (ranks.size (), SCM_EOL);
-      for (vsize i = 0; i < ranks.size (); i++)
-        scm_vector_set_x (scm_vec, scm_from_int (i), scm_from_int (ranks[i]));
-      me->set_property ("important-column-ranks", scm_vec);
-
-      return request_suicide (me, start, end);
-    }
+  if (end < start)
+    return true;
 
-  return true;
+  /* Is there an important column in [START, END]?  */
+  SCM counts = important_column_counts (me);
+  int after_end = (end == INT_MAX) ? end : end + 1;
+  return important_columns_below (counts, after_end)
+         == important_columns_below (counts, start);
 }
 
 void
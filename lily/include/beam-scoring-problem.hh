@@ -117,9 +117,13 @@ class Beam_scoring_problem
 public:
   Beam_scoring_problem (Grob *me, Drul_array<Real> ys, bool);
   Drul_array<Real> solve () const;
+  bool has_plain_solution () const;
+  bool search (Interval *positions) const;
+  void count_scorers () const;
 
 private:
   Spanner *beam_;
+  mutable int scorer_calls_;
 
   Interval unquanted_y_;
   bool align_broken_intos_;
@@ -181,6 +185,7 @@ private:
   void one_scorer (Beam_configuration *config) const;
   Beam_configuration *force_score (SCM inspect_quants,
                                    const vector<Beam_configuration *> &configs) const;
+  Beam_configuration *best_configuration (vector<Beam_configuration *> const &configs) const;
   Real y_at (Real x, Beam_configuration const *c) const;
 
   // Scoring functions:
@@ -0,0 +1,65 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BREAK_SUBSTITUTION_HH
+#define BREAK_SUBSTITUTION_HH
+
+#include "interval.hh"
+#include "lily-proto.hh"
+#include "std-vector.hh"
+
+/*
+  Lookup table for substituting grobs into broken systems.
+
+  Every grob of the root system gets a dense index.  Per index we
+  store the range of system ranks the grob can be substituted into,
+  and a slot per system in that range holding the substituted grob.
+  Slots are filled on first use, so each (grob, system) pair is
+  resolved only once.
+
+  While a table is alive, substitute_grob () uses it for substitution
+  into a System.
+*/
+class Break_substitution_table
+{
+  vector<Grob *> grobs_;
+  vector<System *> systems_;
+  vector<Slice> ranges_;
+  vector<vsize> offsets_;
+  vector<Grob *> substitutes_;
+  vector<bool> known_;
+
+  static Break_substitution_table *current_;
+
+public:
+  vsize lookup_count_;
+  vsize resolve_count_;
+
+  Break_substitution_table (System *root);
+  ~Break_substitution_table ();
+
+  static Break_substitution_table *current () { return current_; }
+
+  vsize size () const { return grobs_.size (); }
+  bool has_grob (Grob const *) const;
+  Slice system_range (Grob const *) const;
+  Grob *substitute (Grob *, int rank);
+};
+
+#endif /* BREAK_SUBSTITUTION_HH */
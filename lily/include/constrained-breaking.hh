@@ -134,12 +134,16 @@ struct Constrained_break_node
   /* unlike the Gourlay breaker, this is the sum of all demerits up to,
    * and including, this line */
   Real demerits_;
-  struct Line_details details_;
+
+  /* the force of this line; its other details are in the line
+     from prev_ to here */
+  Real force_;
 
   Constrained_break_node ()
   {
     prev_ = -1;
     demerits_ = infinity_f;
+    force_ = infinity_f;
   }
 
   void print () const
@@ -180,9 +184,10 @@ private:
   Real score_markup_min_distance_;
   Real score_markup_padding_;
 
-  /* the (i,j)th entry is the configuration for breaking between
-    columns i and j */
-  Matrix<Line_details> lines_;
+  /* the [i][k]th entry is the configuration for breaking between
+    breakpoints i and i + k + 1.  Only lines that fit are stored, which
+    keeps this linear in the length of the score. */
+  vector<vector<Line_details> > lines_;
 
   /* the [i](j,k)th entry is the score for fitting the first k bars onto the
     first j systems, starting at the i'th allowed starting column */
@@ -197,6 +202,8 @@ private:
   void initialize ();
   void resize (vsize systems);
 
+  Line_details const &line (vsize start_brk, vsize end_brk) const;
+
   Column_x_positions space_line (vsize start_col, vsize end_col);
   vsize prepare_solution (vsize start, vsize end, vsize sys_count);
 
@@ -0,0 +1,67 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef CONTEXT_PROPERTY_CACHE_HH
+#define CONTEXT_PROPERTY_CACHE_HH
+
+#include "lily-guile.hh"
+#include "lily-proto.hh"
+#include "std-vector.hh"
+
+/*
+  Per-context cache of resolved property lookups, indexed by symbol.
+  Each entry records the value found and the context (this one or an
+  ancestor) that defines it, or 0 if no context does.
+
+  Entries are stamped with a global generation number.  Any property
+  assignment or change of the context tree bumps the generation,
+  which invalidates all entries at once.
+*/
+class Context_property_cache
+{
+  struct Entry
+  {
+    SCM sym_;
+    unsigned long generation_;
+    SCM value_;
+    Context *where_;
+  };
+
+  vector<Entry> entries_;
+  vsize count_;
+
+  static unsigned long generation_;
+
+  vsize slot (SCM sym) const;
+  void grow ();
+
+public:
+  static long lookups_;
+  static long hits_;
+  static long chain_depth_;
+
+  static void invalidate_all () { generation_++; }
+
+  Context_property_cache ();
+  bool get (SCM sym, SCM *value, Context **where) const;
+  void set (SCM sym, SCM value, Context *where);
+  void mark () const;
+};
+
+#endif /* CONTEXT_PROPERTY_CACHE_HH */
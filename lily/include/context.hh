@@ -20,6 +20,7 @@
 #ifndef CONTEXT_HH
 #define CONTEXT_HH
 
+#include "context-property-cache.hh"
 #include "duration.hh"
 #include "lily-proto.hh"
 #include "listener.hh"
@@ -37,6 +38,7 @@ public:
   virtual ~Context ();
 private:
   Scheme_hash_table *properties_dict () const;
+  Context *resolve_property (SCM sym, SCM *value) const;
   Context (Context const &src); // Do not define!  Not copyable!
 
   DECLARE_CLASSNAME (Context);
@@ -59,6 +61,7 @@ protected:
   SCM definition_mods_;
 
   SCM properties_scm_;
+  mutable Context_property_cache property_cache_;
   SCM context_list_;
   SCM accepts_list_;
   SCM default_child_;
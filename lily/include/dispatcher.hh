@@ -23,6 +23,7 @@
 #include "listener.hh"
 #include "stream-event.hh"
 #include "smobs.hh"
+#include "std-vector.hh"
 
 class Dispatcher : public Smob<Dispatcher>
 {
@@ -43,6 +44,25 @@ private:
      first. */
   int priority_count_;
   void internal_add_listener (SCM callback, SCM event_class, int priority);
+
+  struct Plan_entry
+  {
+    int priority_;
+    SCM callback_;
+  };
+  /* For each class list seen by dispatch (), the listeners of all its
+     classes, sorted by priority and without duplicate priorities.
+     PLAN_TABLE_ maps a class list to its index in PLANS_.  Plans are
+     discarded whenever registrations change.  While DISPATCH_DEPTH_
+     calls of dispatch () are walking plans, discarded plans are only
+     removed from PLAN_TABLE_, and PLANS_STALE_ is set.  */
+  vector<vector<Plan_entry> > plans_;
+  SCM plan_table_;
+  int dispatch_depth_;
+  bool plans_stale_;
+  static bool plan_entry_less (Plan_entry const &, Plan_entry const &);
+  vsize find_plan (SCM class_list);
+  void invalidate_plans ();
 public:
   Dispatcher ();
   void broadcast (Stream_event *ev);
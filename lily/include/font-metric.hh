@@ -24,6 +24,7 @@
 #include "freetype.hh"
 #include "lily-proto.hh"
 #include "smobs.hh"
+#include "stencil.hh"
 #include "virtual-methods.hh"
 
 #include <map>
@@ -65,6 +66,10 @@ private:
   /* No copying, no implicit copy constructor.  */
   Font_metric (Font_metric const &);
 
+  /* The stencils returned by find_by_name, which all grobs showing
+     the same glyph share.  */
+  mutable std::map<string, Stencil> glyph_stencils_;
+
 protected:
   virtual void derived_mark () const;
 
@@ -73,5 +78,6 @@ protected:
 
 
 vector<char> pfb2pfa (const vector<char> &pfb);
+vector<string> type1_pdf_segments (const vector<char> &type1);
 
 #endif /* FONT_METRIC_HH */
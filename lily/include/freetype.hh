@@ -36,5 +36,6 @@ SCM box_to_scheme_lines (Box b);
 Box ly_FT_get_unscaled_indexed_char_dimensions (FT_Face const &face, size_t signed_idx);
 Box ly_FT_get_glyph_outline_bbox (FT_Face const &face, size_t signed_idx);
 SCM ly_FT_get_glyph_outline (FT_Face const &face, size_t signed_idx);
+FT_UInt ly_FT_name_to_index (FT_Face const &face, string const &name);
 
 #endif /* FREETYPE_HH */
@@ -61,5 +61,7 @@ protected:
 };
 
 SCM ly_format_output (SCM);
+SCM ly_make_global_context (SCM);
+SCM ly_interpret_music_expression (SCM, SCM);
 
 #endif // GLOBAL_CONTEXT_HH
@@ -56,6 +56,9 @@ protected:
   */
   SCM interfaces_;
 
+  /* Index in the current Break_substitution_table, or VPOS.  */
+  vsize break_substitution_index_;
+
   void substitute_object_links (SCM, SCM);
   Real get_offset (Axis a) const;
   SCM try_callback (SCM, SCM);
@@ -67,6 +70,7 @@ public:
   /* friends */
   friend class Spanner;
   friend class System;
+  friend class Break_substitution_table;
   friend SCM ly_grob_properties (SCM);
   friend SCM ly_grob_basic_properties (SCM);
 
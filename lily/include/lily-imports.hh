@@ -55,6 +55,7 @@ namespace Lily {
   extern Variable backend_testing;
   extern Variable base_length;
   extern Variable beam_exceptions;
+  extern Variable beam_place_broken_parts_individually;
   extern Variable beat_structure;
   extern Variable calc_repeat_slash_count;
   extern Variable car_less;
@@ -133,6 +133,7 @@ class Pitch;
 class Pitch_squash_engraver;
 class Prob;
 class Property_iterator;
+class Raster_canvas;
 class Relative_octave_music;
 class Repeated_music;
 class Rhythmic_music_iterator;
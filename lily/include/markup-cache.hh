@@ -0,0 +1,50 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MARKUP_CACHE_HH
+#define MARKUP_CACHE_HH
+
+#include "lily-guile.hh"
+
+/*
+  Memoization of markup interpretation (-dmemoize-markup).
+
+  While a markup is interpreted, the property and output definition
+  lookups that it makes are recorded.  The resulting stencil is reused
+  for an equal markup with the same layout if these lookups give the
+  same results.
+*/
+class Markup_cache
+{
+  static int recording_;
+  static void pop_frame (void *);
+
+public:
+  static bool is_enabled ();
+  static bool is_recording () { return recording_; }
+
+  static SCM lookup (SCM layout, SCM props, SCM markup);
+  static void start_recording (SCM props);
+  static void store (SCM layout, SCM markup, SCM stencil);
+
+  static void note_property_read (SCM key, SCM chain, SCM where, SCM value);
+  static void note_variable_read (SCM def, SCM sym, SCM value);
+};
+
+#endif /* MARKUP_CACHE_HH */
@@ -57,8 +57,13 @@ public:
   I64 den () const;
   I64 num () const;
   /*
-    Deliver a copy of THIS as a smobified SCM
+    Deliver a copy of THIS as a smobified SCM.  Common values are
+    interned, so the result must not be modified.
   */
+  SCM smobbed_copy () const;
+  static long smob_count_;
+  static long interned_count_;
+
   string to_string () const;
   static int compare (Moment const &, Moment const &);
   SCM as_scheme () const;
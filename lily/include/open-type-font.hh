@@ -52,6 +52,8 @@ public:
   SCM glyph_list () const;
   SCM get_glyph_outline (size_t signed_idx) const;
   Box get_glyph_outline_bbox (size_t signed_idx) const;
+  void fill_glyph (Raster_canvas *, size_t signed_idx, Real size,
+                   Offset origin) const;
   string get_otf_table (const string &tag) const;
   static SCM make_otf (const string&);
   string font_name () const;
@@ -60,6 +62,7 @@ public:
   size_t count () const;
   Box get_indexed_char_dimensions (size_t) const;
   Box get_unscaled_indexed_char_dimensions (size_t) const;
+  Real get_indexed_advance (size_t) const;
   size_t name_to_index (string) const;
   size_t index_to_charcode (size_t) const;
   void derived_mark () const;
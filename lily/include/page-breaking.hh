@@ -172,6 +172,7 @@ protected:
   Page_spacing_result pack_systems_on_least_pages (vsize configuration_index,
                                                    vsize first_page_num);
   vsize min_page_count (vsize configuration_index, vsize first_page_num);
+  Real min_demerits (vsize configuration_index);
   bool all_lines_stretched (vsize configuration_index);
   Real blank_page_penalty () const;
 
@@ -65,6 +65,7 @@ private:
       prev_ = VPOS;
       system_count_status_ = SYSTEM_COUNT_OK;
       page_ = 0;
+      min_demerits_ = -infinity_f;
     }
 
     Real demerits_;
@@ -73,6 +74,11 @@ private:
     vsize prev_;
     vsize page_;
     int system_count_status_;
+
+    // The least demerits_ of this node and of the nodes for fewer
+    // lines on the same number of pages.  Nodes that were never
+    // computed give no bound.
+    Real min_demerits_;
   };
 
   Page_breaking const *breaker_;
@@ -90,6 +96,9 @@ private:
   bool ragged_;
   bool ragged_last_;
 
+  // A lower bound for the penalty of any page.
+  Real min_penalty_;
+
   void resize (vsize page_count);
   bool calc_subproblem (vsize page, vsize lines);
 };
@@ -26,6 +26,7 @@
 
 #include <pango/pango.h>
 #include <pango/pangoft2.h>
+#include <map>
 
 #include "font-metric.hh"
 
@@ -43,6 +44,11 @@ class Pango_font : Preinit_Pango_font, public Font_metric
   Real output_scale_;
   Direction text_direction_;
 
+  /* FreeType faces of the physical fonts, by PostScript name, opened
+     for the built-in rasterizer.  */
+  mutable map<string, FT_Face> physical_faces_;
+  FT_Face physical_face (SCM ps_name) const;
+
 public:
   SCM physical_font_tab () const;
   Pango_font (PangoFT2FontMap *,
@@ -57,6 +63,8 @@ public:
   size_t name_to_index (string) const;
   SCM get_glyph_outline (size_t signed_idx) const;
   Box get_glyph_outline_bbox (size_t signed_idx) const;
+  void fill_glyph (Raster_canvas *, SCM ps_name, SCM char_id, Real size,
+                   Offset origin) const;
   Box get_unscaled_indexed_char_dimensions (size_t) const;
   Box get_scaled_indexed_char_dimensions (size_t) const;
 
@@ -25,6 +25,8 @@
 class Protected_scm;
 
 void note_property_access (Protected_scm *table, SCM sym);
+void note_callback_time (SCM key, Real seconds);
+extern Protected_scm callback_time_table;
 extern Protected_scm context_property_lookup_table;
 extern Protected_scm grob_property_lookup_table;
 extern Protected_scm prob_property_lookup_table;
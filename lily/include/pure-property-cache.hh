@@ -0,0 +1,62 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PURE_PROPERTY_CACHE_HH
+#define PURE_PROPERTY_CACHE_HH
+
+#include "lily-guile.hh"
+#include "std-vector.hh"
+
+/*
+  Cache for pure properties of a spanner, indexed by (SYM, START,
+  END), where SYM is a symbol and START and END are the column ranks
+  of the current line.
+
+  This is an open addressing hash table with linear probing.  Keys
+  are stored unboxed, so lookups do not allocate.  Values must be
+  marked by the owner through mark ().
+*/
+class Pure_property_cache
+{
+  struct Entry
+  {
+    SCM sym_;
+    int start_;
+    int end_;
+    SCM value_;
+  };
+
+  vector<Entry> entries_;
+  vsize count_;
+
+  vsize slot (SCM sym, int start, int end) const;
+  void grow ();
+
+public:
+  static bool enabled_;
+  static long hits_;
+  static long misses_;
+
+  Pure_property_cache ();
+  SCM get (SCM sym, int start, int end) const;
+  void set (SCM sym, int start, int end, SCM value);
+  void mark () const;
+};
+
+#endif /* PURE_PROPERTY_CACHE_HH */
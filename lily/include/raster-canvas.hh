@@ -0,0 +1,90 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef RASTER_CANVAS_HH
+#define RASTER_CANVAS_HH
+
+#include <pango/pango-matrix.h>
+
+#include "freetype.hh"
+#include "offset.hh"
+#include "std-vector.hh"
+
+/*
+  An RGB pixel buffer with an anti-aliased scan converter.
+
+  Paths are built in user coordinates, which are mapped to pixels by
+  the current transformation.  Coverage is computed exactly from the
+  signed area of the path edges in every pixel, using the nonzero
+  winding rule, so no supersampling is needed.
+*/
+class Raster_canvas
+{
+  struct Color
+  {
+    Real r_, g_, b_;
+  };
+
+  int width_;
+  int height_;
+  vector<unsigned char> pixels_;
+
+  vector<PangoMatrix> transforms_;
+  vector<Color> colors_;
+
+  /* The current path, flattened, in user coordinates.  */
+  vector<vector<Offset> > path_;
+  vector<bool> closed_;
+
+  Real flatness () const;
+  Offset device (Offset) const;
+  void continue_path ();
+  void fill_polygons (vector<vector<Offset> > const &, bool orient);
+  void stroke_polygons (vector<Offset> const &, bool closed,
+                        Real thickness, int cap, int join,
+                        vector<vector<Offset> > *) const;
+
+public:
+  enum { BUTT_CAP, ROUND_CAP, SQUARE_CAP };
+  enum { MITER_JOIN, ROUND_JOIN, BEVEL_JOIN };
+
+  Raster_canvas (int width, int height, PangoMatrix const &device);
+
+  int width () const { return width_; }
+  int height () const { return height_; }
+
+  void push_transform (PangoMatrix const &);
+  void pop_transform ();
+  void push_color (Real r, Real g, Real b);
+  void pop_color ();
+
+  void move_to (Offset);
+  void line_to (Offset);
+  void curve_to (Offset, Offset, Offset);
+  void close_path ();
+
+  void fill ();
+  void stroke (Real thickness, int cap, int join);
+  void fill_and_stroke (Real thickness, int cap, int join);
+  void fill_glyph (FT_Face face, size_t idx, Real scale, Offset origin);
+
+  bool write_png (string const &file_name) const;
+};
+
+#endif /* RASTER_CANVAS_HH */
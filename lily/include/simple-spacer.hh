@@ -56,11 +56,14 @@ private:
   bool fits_;
 };
 
-/* returns a vector of dimensions breaks.size () * breaks.size () */
-vector<Real> get_line_forces (vector<Grob *> const &columns,
-                              Real line_len,
-                              Real indent,
-                              bool ragged);
+/* returns, for every breakpoint b, the forces of the lines from b to
+   the following breakpoints, as far as they fit.  The force of the line
+   from b to c is element c - b - 1 of the b'th vector; lines past the
+   end of that vector do not fit. */
+vector<vector<Real> > get_line_forces (vector<Grob *> const &columns,
+                                       Real line_len,
+                                       Real indent,
+                                       bool ragged);
 
 Column_x_positions get_line_configuration (vector<Grob *> const &columns,
                                            Real line_len,
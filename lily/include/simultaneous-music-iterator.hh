@@ -22,6 +22,8 @@
 
 #include "music-iterator.hh"
 
+#include <queue>
+
 class Simultaneous_music_iterator : public Music_iterator
 {
 public:
@@ -45,7 +47,34 @@ protected:
   virtual void process (Moment);
 
 private:
+  /*
+    A child iterator with the moment it was waiting for when it was
+    queued.  An iterator's pending moment only changes when it is
+    processed, so it is fetched once after every process () call.
+    RANK_ is the position among the elements: iterators that are due
+    at the same moment are processed in the order of the music.
+  */
+  struct Child
+  {
+    Music_iterator *iter_;
+    Moment when_;
+    vsize rank_;
+  };
+  struct Child_later
+  {
+    bool operator () (Child const &, Child const &) const;
+  };
+  static bool rank_less (Child const &, Child const &);
+  void schedule (Music_iterator *, vsize rank);
+
   SCM children_list_;
+
+  /* Children that only need processing at their pending moment,
+     earliest first.  */
+  std::priority_queue<Child, vector<Child>, Child_later> queue_;
+
+  /* Children that want to be processed at every moment, in order.  */
+  vector<Child> always_;
 };
 
 #endif // SIMULTANEOUS_MUSIC_ITERATOR_HH
@@ -74,6 +74,7 @@ public:
 
   vector<Offset> to_points (Axis) const;
   void merge (Skyline const &);
+  void merge (Skyline const &, Real raise);
   void insert (Box const &, Axis);
   void print () const;
   void print_points () const;
@@ -101,6 +102,24 @@ public:
   DECLARE_SCHEME_CALLBACK (get_max_height, (SCM));
   DECLARE_SCHEME_CALLBACK (get_max_height_position, (SCM));
   DECLARE_SCHEME_CALLBACK (get_height, (SCM, SCM));
+
+  friend class Skyline_index;
+};
+
+/*
+  Random access to the buildings of a large skyline, for measuring
+  distances to small skylines in time proportional to their width.
+*/
+class Skyline_index
+{
+  Direction sky_;
+  vector<Building> buildings_;
+
+public:
+  Skyline_index ();
+  Skyline_index (Skyline const &);
+
+  Skyline section (Interval) const;
 };
 
 extern bool debug_skylines;
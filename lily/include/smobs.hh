@@ -168,10 +168,32 @@ public:
   static void init ();
 };
 
+// Allocation counts for one smob type.  Every Smob_base<Super> has
+// one; they are chained together when the type is initialized, so
+// that memory use can be reported per type (see -dmemory-report).
+// Counting costs an increment per allocation and free, so it is
+// always done.
+
+struct Smob_count
+{
+  static Smob_count *list_;
+  Smob_count *next_;
+  const char *name_;
+  size_t size_;
+  unsigned long allocated_;
+  unsigned long freed_;
+
+  void enroll (const char *name, size_t size);
+  unsigned long live () const { return allocated_ - freed_; }
+};
+
+void report_memory (const string &phase);
+
 template <class Super>
 class Smob_base
 {
   static scm_t_bits smob_tag_;
+  static Smob_count count_;
   static Scm_init scm_init_;
   static void init (void);
   static string smob_name_;
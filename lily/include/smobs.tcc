@@ -57,6 +57,7 @@ Smob_base<Super>::register_ptr (Super *p)
   SCM s = SCM_UNDEFINED;
   SCM_NEWSMOB (s, smob_tag (), p);
   scm_gc_register_collectable_memory (p, sizeof (*p), smob_name_.c_str ());
+  count_.allocated_++;
   return s;
 }
 
@@ -100,6 +101,7 @@ Smob_base<Super>::unregister_ptr (SCM obj)
 {
   Super *p = Super::unchecked_unsmob (obj);
   scm_gc_unregister_collectable_memory (p, sizeof (*p), smob_name_.c_str ());
+  count_.freed_++;
   SCM_SET_SMOB_DATA (obj, static_cast<Super *> (0));
   return p;
 }
@@ -107,6 +109,9 @@ Smob_base<Super>::unregister_ptr (SCM obj)
 template <class Super>
 scm_t_bits Smob_base<Super>::smob_tag_ = 0;
 
+template <class Super>
+Smob_count Smob_base<Super>::count_;
+
 template <class Super>
 Scm_init Smob_base<Super>::scm_init_ (init);
 
@@ -127,6 +132,7 @@ void Smob_base<Super>::init ()
   smob_name_ = smob_name_.substr (smob_name_.find_first_not_of ("0123456789"));
   assert(!smob_tag_);
   smob_tag_ = scm_make_smob_type (smob_name_.c_str (), 0);
+  count_.enroll (smob_name_.c_str (), sizeof (Super));
   // The following have trivial private default definitions not
   // referring to any aspect of the Super class apart from its name.
   // They should be overridden (or rather masked) at Super level: that
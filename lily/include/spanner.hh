@@ -21,6 +21,7 @@
 #define SPANNER_HH
 
 #include "grob.hh"
+#include "pure-property-cache.hh"
 #include "rod.hh"
 
 /** A symbol which is attached between two columns. A spanner is a
@@ -43,7 +44,7 @@
 struct Preinit_Spanner
 {
   Drul_array<Item *> spanned_drul_;
-  SCM pure_property_cache_;
+  Pure_property_cache pure_property_cache_;
   Preinit_Spanner ();
 };
 
@@ -35,6 +35,7 @@ class System : public Spanner
   Grob_array *all_elements_;
   void init_elements ();
   friend class Paper_score;     // ugh.
+  friend class Break_substitution_table;
   Paper_score *pscore_; // ugh.
 
 public:
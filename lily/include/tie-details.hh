@@ -53,6 +53,7 @@ struct Tie_details
 
   int single_tie_region_size_;
   int multi_tie_region_size_;
+  int variation_search_depth_;
   Direction neutral_direction_;
 
   Tie_details ();
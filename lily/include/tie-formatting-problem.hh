@@ -41,6 +41,21 @@ struct Tie_configuration_variation
   }
 };
 
+/*
+  Demerits of a Ties_configuration, split in the parts that a
+  variation can change independently: each tie on its own, each pair
+  of vertically adjacent ties, and the outer (first, last) pair.
+*/
+struct Tie_score_components
+{
+  vector<Real> tie_scores_;
+  vector<Real> adjacent_scores_;
+  Real outer_score_;
+
+  Tie_score_components ();
+  Real total () const;
+};
+
 typedef map < Tuple<int, 2>, Skyline> Chord_outline_map;
 typedef map < Tuple<int, 2>, Box> Column_extent_map;
 typedef map <int, Slice> Position_extent_map;
@@ -76,11 +91,26 @@ class Tie_formatting_problem
   void score_ties_configuration (Ties_configuration *ties) const;
   void set_ties_config_standard_directions (Ties_configuration *tie_configs_ptr);
   void score_ties (Ties_configuration *) const;
+  Real score_adjacent_ties (Tie_configuration const &, Tie_configuration const &,
+                            Ties_configuration *) const;
+  Real score_outer_ties (Tie_configuration const &, Tie_configuration const &,
+                         Ties_configuration *) const;
+
+  Tie_score_components score_ties_components (Ties_configuration *) const;
+  void rescore_ties_components (Ties_configuration *, vector<bool> const &,
+                                Tie_score_components *) const;
+  void search_variations (Ties_configuration *, Tie_score_components *,
+                          vector<Tie_configuration_variation> const &,
+                          vector<vector<bool> > const &,
+                          vsize, int, vector<bool> *,
+                          vector<vsize> *, Real *, vector<vsize> *) const;
 
   Slice head_positions_slice (int) const;
   Ties_configuration generate_base_chord_configuration ();
   Ties_configuration find_best_variation (Ties_configuration const &base,
                                           vector<Tie_configuration_variation> const &vars);
+  Ties_configuration find_best_single_variation (Ties_configuration const &base,
+                                                 vector<Tie_configuration_variation> const &vars);
 
 public:
   Tie_details details_;
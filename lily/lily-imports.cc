@@ -49,6 +49,7 @@ namespace Lily {
   Variable backend_testing ("backend-testing");
   Variable base_length ("base-length");
   Variable beam_exceptions ("beam-exceptions");
+  Variable beam_place_broken_parts_individually ("beam::place-broken-parts-individually");
   Variable beat_structure ("beat-structure");
   Variable calc_repeat_slash_count ("calc-repeat-slash-count");
   Variable car_less ("car<");
@@ -23,6 +23,7 @@
 #include "book.hh"
 #include "file-name.hh"
 #include "file-path.hh"
+#include "gc-pacing.hh"
 #include "international.hh"
 #include "lily-lexer.hh"
 #include "lily-version.hh"
@@ -103,6 +104,7 @@ Lily_parser::parse_file (const string &init, const string &name, const string &o
 
   lexer_->main_input_name_ = name;
 
+  gc_pacing_start_file ();
   message (_ ("Parsing..."));
 
   set_yydebug (0);
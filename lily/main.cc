@@ -29,6 +29,7 @@ using namespace std;
 
 #include <unistd.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include "config.hh"
 
 #if HAVE_GRP_H
@@ -79,6 +80,9 @@ using namespace std;
 /* Provide URI links to the original file */
 bool point_and_click_global = true;
 
+/* Scale the initial garbage collector settings with the input size?  */
+static bool adaptive_gc = false;
+
 /* Scheme code to execute before parsing, after .scm init.
    This is where -e arguments are appended to.  */
 //string init_scheme_code_global; // moved to global-data.cc
@@ -633,6 +637,13 @@ parse_argv (int argc, char **argv)
                 val = arg.substr (eq + 1, arg.length () - 1);
               }
 
+            /* The garbage collector is set up before Scheme options
+               are read.  */
+            if (key == "adaptive-gc")
+              adaptive_gc = val != "#f";
+            else if (key == "no-adaptive-gc")
+              adaptive_gc = false;
+
             init_scheme_variables_global
             += "(cons \'" + key + " '" + val + ")\n";
           }
@@ -717,18 +728,55 @@ parse_argv (int argc, char **argv)
   T1686 Add two new routines called by setup_guile_env
 */
 
+static size_t
+input_file_size (int argc, char **argv)
+/*
+ * Return the total size of the input files on the command line.
+ * Arguments of options are counted too if they happen to name
+ * files, which is good enough for estimating memory needs.
+ */
+{
+  size_t total = 0;
+  for (int i = 1; i < argc; i++)
+    {
+      if (argv[i][0] == '-')
+        continue;
+
+      struct stat sbuf;
+      string name = argv[i];
+      if (stat (name.c_str (), &sbuf) == 0
+          || stat ((name + ".ly").c_str (), &sbuf) == 0)
+        if (S_ISREG (sbuf.st_mode))
+          total += sbuf.st_size;
+    }
+  return total;
+}
+
 void
-setup_guile_gc_env ()
+setup_guile_gc_env (int argc, char **argv)
 /*
  * Set up environment variables relevant to the
  * Garbage Collector
+ *
+ * With -dadaptive-gc, the initial heap and the yield (the percentage
+ * of the heap that a collection must free for the heap not to grow)
+ * are scaled with the size of the input: a snippet is done before a
+ * large heap pays off, while a large score spends most of its time
+ * collecting garbage if the heap stays small.  Explicit settings
+ * always win.  See also gc-pacing.cc.
  */
 {
+  size_t input = adaptive_gc ? input_file_size (argc, argv) : 0;
+
   char const *yield = getenv ("LILYPOND_GC_YIELD");
   bool overwrite = true;
   if (!yield)
     {
       yield = "65";
+      if (adaptive_gc && input < 16 << 10)
+        yield = "50";
+      else if (adaptive_gc && input >= 256 << 10)
+        yield = "80";
       overwrite = false;
     }
 
@@ -736,10 +784,14 @@ setup_guile_gc_env ()
   sane_putenv ("GUILE_MIN_YIELD_2", yield, overwrite);
   sane_putenv ("GUILE_MIN_YIELD_MALLOC", yield, overwrite);
 
+  size_t const max_segment = 100 << 20;
+  size_t segment = 10 << 20;
+  if (adaptive_gc)
+    segment = min (max (size_t (4 << 20), 512 * input), max_segment);
   sane_putenv ("GUILE_INIT_SEGMENT_SIZE_1",
-               "10485760", overwrite);
+               String_convert::unsigned_long_string (segment), overwrite);
   sane_putenv ("GUILE_MAX_SEGMENT_SIZE",
-               "104857600", overwrite);
+               String_convert::unsigned_long_string (max_segment), overwrite);
 }
 
 
@@ -762,13 +814,13 @@ setup_guile_v2_env ()
 }
 
 void
-setup_guile_env ()
+setup_guile_env (int argc, char **argv)
 /*
  * Set up environment variables relevant to Scheme
  */
 {
 
-  setup_guile_gc_env ();  // configure garbage collector
+  setup_guile_gc_env (argc, argv);  // configure garbage collector
 #if (GUILEV2)
   setup_guile_v2_env ();  // configure Guile V2 behaviour
 #endif
@@ -808,7 +860,7 @@ main (int argc, char **argv, char **envp)
     identify (stderr);
 
   setup_paths (argv[0]);
-  setup_guile_env ();  // set up environment variables to pass into Guile API
+  setup_guile_env (argc, argv);  // set up environment variables to pass into Guile API
   /*
    * Start up Guile API using main_with_guile as a callback.
    */
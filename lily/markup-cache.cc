@@ -0,0 +1,288 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "markup-cache.hh"
+
+#include "output-def.hh"
+#include "program-option.hh"
+#include "stencil.hh"
+
+/*
+  Markups are keyed by their layout (in a weak table, so that the
+  entries go away with the layout) and then by equal? on the markup.
+  Every entry is a list
+
+    (STENCIL PROPERTY-READS VARIABLE-READS)
+
+  where PROPERTY-READS is an alist of properties with the values they
+  had, and VARIABLE-READS a list of (OUTPUT-DEF SYMBOL . VALUE).
+  Missing entries are recorded with the value NOT_FOUND.  Reads from
+  the layout itself are stored with #t instead of the layout, since a
+  strong reference from the value would keep the weak key alive.  The
+  whole cache is cleared at the end of every file as well.
+
+  While markups are being interpreted, there is a recording frame for
+  each of them, innermost first.  A property lookup is recorded in a
+  frame if it can be answered from the frame's own properties.  If the
+  chain that was searched is built by prepending alists to those
+  properties, as markup commands do, the prepended part only depends
+  on things that are recorded already.  Lookups in chains that use
+  part of the frame's properties in any other way cannot be expressed
+  in terms of them, and make the markup uncacheable.
+
+  Markups are only interpreted on the main thread, so the frames need
+  no locking.
+*/
+
+enum
+{
+  FRAME_PROPS,
+  FRAME_PROPERTY_READS,
+  FRAME_VARIABLE_READS,
+  FRAME_CACHEABLE,
+  FRAME_SIZE
+};
+
+/* More entries for a single markup suggest that it depends on
+   something that changes all the time, like a page number.  */
+static const int MAX_ENTRIES_PER_MARKUP = 8;
+
+int Markup_cache::recording_ = 0;
+
+static SCM cache = SCM_BOOL_F;
+static SCM frames = SCM_BOOL_F;
+static SCM not_found = SCM_BOOL_F;
+
+static long hits = 0;
+static long misses = 0;
+static long stored = 0;
+static long uncacheable = 0;
+
+static void
+init_markup_cache ()
+{
+  cache = scm_make_weak_key_hash_table (scm_from_int (17));
+  scm_gc_protect_object (cache);
+  frames = scm_list_1 (SCM_EOL);
+  scm_gc_protect_object (frames);
+  not_found = scm_cons (ly_symbol2scm ("not-found"), SCM_EOL);
+  scm_gc_protect_object (not_found);
+}
+ADD_SCM_INIT_FUNC (markup_cache, init_markup_cache);
+
+bool
+Markup_cache::is_enabled ()
+{
+  return get_program_option ("memoize-markup");
+}
+
+static void
+add_read (SCM frame, int field, SCM read)
+{
+  scm_c_vector_set_x (frame, field,
+                      scm_cons (read, scm_c_vector_ref (frame, field)));
+}
+
+void
+Markup_cache::note_property_read (SCM key, SCM chain, SCM where, SCM value)
+{
+  for (SCM f = scm_car (frames); scm_is_pair (f); f = scm_cdr (f))
+    {
+      SCM frame = scm_car (f);
+      SCM props = scm_c_vector_ref (frame, FRAME_PROPS);
+      for (SCM s = chain;; s = scm_cdr (s))
+        {
+          if (scm_is_eq (s, props))
+            {
+              SCM reads = scm_c_vector_ref (frame, FRAME_PROPERTY_READS);
+              if (scm_is_false (scm_assq (key, reads)))
+                add_read (frame, FRAME_PROPERTY_READS,
+                          scm_cons (key, scm_is_pair (where)
+                                    ? value : not_found));
+              break;
+            }
+          if (!scm_is_pair (s))
+            break;
+          if (scm_is_true (scm_memq (scm_car (s), props)))
+            {
+              scm_c_vector_set_x (frame, FRAME_CACHEABLE, SCM_BOOL_F);
+              break;
+            }
+          if (scm_is_eq (s, where))
+            break;
+        }
+    }
+}
+
+void
+Markup_cache::note_variable_read (SCM def, SCM sym, SCM value)
+{
+  if (SCM_UNBNDP (value))
+    value = not_found;
+  for (SCM f = scm_car (frames); scm_is_pair (f); f = scm_cdr (f))
+    {
+      SCM reads = scm_c_vector_ref (scm_car (f), FRAME_VARIABLE_READS);
+      SCM s = reads;
+      for (; scm_is_pair (s); s = scm_cdr (s))
+        if (scm_is_eq (scm_caar (s), def) && scm_is_eq (scm_cadar (s), sym))
+          break;
+      if (!scm_is_pair (s))
+        add_read (scm_car (f), FRAME_VARIABLE_READS,
+                  scm_cons (def, scm_cons (sym, value)));
+    }
+}
+
+static bool
+is_valid (SCM entry, SCM layout, SCM props)
+{
+  for (SCM s = scm_cadr (entry); scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM read = scm_car (s);
+      SCM value = ly_chain_assoc_get (scm_car (read), props, not_found);
+      if (!ly_is_equal (value, scm_cdr (read)))
+        return false;
+    }
+  for (SCM s = scm_caddr (entry); scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM read = scm_car (s);
+      SCM def_scm = scm_car (read);
+      Output_def *def = unsmob<Output_def> (scm_is_eq (def_scm, SCM_BOOL_T)
+                                            ? layout : def_scm);
+      SCM value = def->lookup_variable (scm_cadr (read));
+      if (SCM_UNBNDP (value))
+        value = not_found;
+      if (!ly_is_equal (value, scm_cddr (read)))
+        return false;
+    }
+  return true;
+}
+
+/*
+  Return a copy of the cached stencil for MARKUP, or SCM_UNDEFINED.
+  Checking an entry repeats its lookups, so they are recorded for the
+  enclosing markups just as if MARKUP had been interpreted.
+*/
+SCM
+Markup_cache::lookup (SCM layout, SCM props, SCM markup)
+{
+  SCM table = scm_hashq_ref (cache, layout, SCM_BOOL_F);
+  if (scm_is_true (table))
+    for (SCM s = scm_hash_ref (table, markup, SCM_EOL);
+         scm_is_pair (s); s = scm_cdr (s))
+      if (is_valid (scm_car (s), layout, props))
+        {
+          hits++;
+          return unsmob<Stencil> (scm_caar (s))->smobbed_copy ();
+        }
+
+  misses++;
+  return SCM_UNDEFINED;
+}
+
+void
+Markup_cache::pop_frame (void *)
+{
+  scm_set_car_x (frames, scm_cdar (frames));
+  Markup_cache::recording_--;
+}
+
+/*
+  Open a recording frame for a markup interpreted with PROPS.  Must be
+  called inside a dynwind context, which closes the frame again.
+*/
+void
+Markup_cache::start_recording (SCM props)
+{
+  SCM frame = scm_c_make_vector (FRAME_SIZE, SCM_EOL);
+  scm_c_vector_set_x (frame, FRAME_PROPS, props);
+  scm_c_vector_set_x (frame, FRAME_CACHEABLE, SCM_BOOL_T);
+  scm_set_car_x (frames, scm_cons (frame, scm_car (frames)));
+  recording_++;
+  scm_dynwind_unwind_handler (pop_frame, 0, SCM_F_WIND_EXPLICITLY);
+}
+
+/*
+  Store STENCIL as the result of MARKUP, with the lookups recorded in
+  the innermost frame.
+*/
+void
+Markup_cache::store (SCM layout, SCM markup, SCM stencil)
+{
+  SCM frame = scm_caar (frames);
+  Stencil *s = unsmob<Stencil> (stencil);
+  if (!s || scm_is_false (scm_c_vector_ref (frame, FRAME_CACHEABLE)))
+    {
+      uncacheable++;
+      return;
+    }
+
+  SCM table = scm_hashq_ref (cache, layout, SCM_BOOL_F);
+  if (scm_is_false (table))
+    {
+      table = scm_c_make_hash_table (59);
+      scm_hashq_set_x (cache, layout, table);
+    }
+
+  SCM variable_reads = SCM_EOL;
+  for (SCM r = scm_c_vector_ref (frame, FRAME_VARIABLE_READS);
+       scm_is_pair (r); r = scm_cdr (r))
+    {
+      SCM read = scm_car (r);
+      if (scm_is_eq (scm_car (read), layout))
+        read = scm_cons (SCM_BOOL_T, scm_cdr (read));
+      variable_reads = scm_cons (read, variable_reads);
+    }
+
+  SCM entry = scm_list_3 (s->smobbed_copy (),
+                          scm_c_vector_ref (frame, FRAME_PROPERTY_READS),
+                          variable_reads);
+  SCM entries = scm_hash_ref (table, markup, SCM_EOL);
+  if (scm_ilength (entries) >= MAX_ENTRIES_PER_MARKUP)
+    entries = scm_list_head (entries,
+                             scm_from_int (MAX_ENTRIES_PER_MARKUP - 1));
+  scm_hash_set_x (table, markup, scm_cons (entry, entries));
+  stored++;
+}
+
+LY_DEFINE (ly_markup_cache_clear, "ly:markup-cache-clear",
+           0, 0, 0, (),
+           "Remove all stencils from the markup cache and reset its"
+           " statistics.")
+{
+  scm_hash_clear_x (cache);
+  hits = misses = stored = uncacheable = 0;
+  return SCM_UNSPECIFIED;
+}
+
+LY_DEFINE (ly_markup_cache_statistics, "ly:markup-cache-statistics",
+           0, 0, 0, (),
+           "Return an alist with the number of @code{hits} and"
+           " @code{misses} of the markup cache, the number of"
+           " @code{stored} stencils and the number of markups that"
+           " could not be cached (@code{uncacheable}).")
+{
+  return scm_list_4 (scm_cons (ly_symbol2scm ("hits"),
+                               scm_from_long (hits)),
+                     scm_cons (ly_symbol2scm ("misses"),
+                               scm_from_long (misses)),
+                     scm_cons (ly_symbol2scm ("stored"),
+                               scm_from_long (stored)),
+                     scm_cons (ly_symbol2scm ("uncacheable"),
+                               scm_from_long (uncacheable)));
+}
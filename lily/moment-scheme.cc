@@ -206,3 +206,15 @@ LY_DEFINE (ly_moment_less_p, "ly:moment<?",
   return ly_bool2scm (*ma < *mb);
 }
 
+
+LY_DEFINE (ly_moment_allocation_stats, "ly:moment-allocation-stats",
+           0, 0, 0, (),
+           "Return an alist with the number of moment smobs"
+           " @code{allocated}, and the number of times an existing"
+           " smob was @code{reused} for a common value.")
+{
+  return scm_list_2 (scm_cons (ly_symbol2scm ("allocated"),
+                               scm_from_long (Moment::smob_count_)),
+                     scm_cons (ly_symbol2scm ("reused"),
+                               scm_from_long (Moment::interned_count_)));
+}
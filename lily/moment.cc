@@ -19,6 +19,7 @@
 
 #include "moment.hh"
 
+#include "protected-scm.hh"
 #include "warn.hh"
 
 Moment::Moment ()
@@ -58,6 +59,58 @@ Moment::print_smob (SCM port, scm_print_state *) const
   return 1;
 }
 
+long Moment::smob_count_ = 0;
+long Moment::interned_count_ = 0;
+
+/*
+  Direct-mapped cache of moment smobs with small power-of-two
+  denominators, such as measure positions and note durations.  The
+  iterators and translators create such smobs at every time step; with
+  the cache, recurring values share one smob.  Collisions simply
+  replace the previous entry.
+*/
+static const int INTERNED_MOMENT_COUNT = 1024;
+static Protected_scm interned_moments;
+
+static bool
+is_internable (Rational const &r)
+{
+  U64 den = r.den ();
+  return !r.is_infinity ()
+         && den <= 1024 && !(den & (den - 1))
+         && r.num () > -4096 && r.num () < 4096;
+}
+
+SCM
+Moment::smobbed_copy () const
+{
+  if (!is_internable (main_part_) || !is_internable (grace_part_))
+    {
+      smob_count_++;
+      return Simple_smob<Moment>::smobbed_copy ();
+    }
+
+  if (!interned_moments.is_bound ())
+    interned_moments = scm_c_make_vector (INTERNED_MOMENT_COUNT, SCM_BOOL_F);
+
+  size_t h = size_t (main_part_.num () * 1031 + main_part_.den ());
+  h = h * 31 + size_t (grace_part_.num () * 1031 + grace_part_.den ());
+  h = (h ^ (h >> 10)) % INTERNED_MOMENT_COUNT;
+
+  SCM entry = scm_c_vector_ref (interned_moments, h);
+  Moment *m = unsmob<Moment> (entry);
+  if (m && *m == *this)
+    {
+      interned_count_++;
+      return entry;
+    }
+
+  smob_count_++;
+  entry = Simple_smob<Moment>::smobbed_copy ();
+  scm_c_vector_set_x (interned_moments, h, entry);
+  return entry;
+}
+
 SCM
 Moment::as_scheme () const
 {
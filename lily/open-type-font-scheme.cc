@@ -128,6 +128,28 @@ LY_DEFINE (ly_otf_glyph_list, "ly:otf-glyph-list", 1, 0, 0,
   return otf->glyph_list ();
 }
 
+LY_DEFINE (ly_otf_glyph_advance, "ly:otf-glyph-advance", 2, 0, 0,
+           (SCM font, SCM glyph),
+           "Return the advance width of the glyph named @var{glyph}"
+           " (a string) in @var{font}, as a fraction of the em size."
+           "  Return@tie{}0 for unknown glyphs.")
+{
+  Modified_font_metric *fm
+    = unsmob<Modified_font_metric> (font);
+  Open_type_font *otf = fm
+                        ? dynamic_cast<Open_type_font *> (fm->original_font ())
+                        : unsmob<Open_type_font> (font);
+
+  SCM_ASSERT_TYPE (otf, font, SCM_ARG1, __FUNCTION__, "OpenType font");
+  LY_ASSERT_TYPE (scm_is_string, glyph, 2);
+
+  size_t idx = otf->name_to_index (ly_scm2string (glyph));
+  if (idx == (size_t) - 1)
+    return scm_from_double (0.0);
+
+  return scm_from_double (otf->get_indexed_advance (idx));
+}
+
 LY_DEFINE (ly_get_font_format, "ly:get-font-format",
            1, 1, 0, (SCM font_file_name, SCM idx),
            "Get the font format for @var{font_file_name},"
@@ -38,6 +38,7 @@ using namespace std;
 #include "dimensions.hh"
 #include "international.hh"
 #include "modified-font-metric.hh"
+#include "raster-canvas.hh"
 #include "warn.hh"
 
 FT_Byte *
@@ -358,6 +359,16 @@ Open_type_font::get_units_per_EM () const
   return face_->units_per_EM;
 }
 
+/*
+  Draw glyph SIGNED_IDX on CANVAS, with an em size of SIZE.
+*/
+void
+Open_type_font::fill_glyph (Raster_canvas *canvas, size_t signed_idx,
+                            Real size, Offset origin) const
+{
+  canvas->fill_glyph (face_, signed_idx, size / face_->units_per_EM, origin);
+}
+
 size_t
 Open_type_font::name_to_index (string nm) const
 {
@@ -374,6 +385,17 @@ Open_type_font::get_unscaled_indexed_char_dimensions (size_t signed_idx) const
   return ly_FT_get_unscaled_indexed_char_dimensions (face_, signed_idx);
 }
 
+/*
+  The advance width of glyph SIGNED_IDX, as a fraction of the em.
+*/
+Real
+Open_type_font::get_indexed_advance (size_t signed_idx) const
+{
+  if (FT_Load_Glyph (face_, FT_UInt (signed_idx), FT_LOAD_NO_SCALE))
+    return 0.0;
+  return Real (face_->glyph->metrics.horiAdvance) / face_->units_per_EM;
+}
+
 Box
 Open_type_font::get_glyph_outline_bbox (size_t signed_idx) const
 {
@@ -25,6 +25,7 @@
 #include "paper-score.hh"
 #include "prob.hh"
 #include "system.hh"
+#include "warn.hh"
 
 Optimal_page_breaking::Optimal_page_breaking (Paper_book *pb)
   : Page_breaking (pb, 0, 0)
@@ -117,6 +118,11 @@ Optimal_page_breaking::solve ()
   else
     message (_f ("Fitting music on %d or %d pages...", (int)page_count - 1, (int)page_count));
 
+  /* Configurations whose line forces alone are worse than the best
+     spacing so far are skipped without spacing them on pages. */
+  int pruned_count = 0;
+  int evaluated_count = 0;
+
   /* try a smaller number of systems than the ideal number for line breaking */
   Line_division bound = ideal_line_division;
   for (vsize sys_count = ideal_sys_count + 1; --sys_count >= min_sys_count;)
@@ -131,6 +137,13 @@ Optimal_page_breaking::solve ()
         {
           Page_spacing_result cur;
 
+          if (min_demerits (i) >= best_for_this_sys_count.demerits_)
+            {
+              pruned_count++;
+              continue;
+            }
+
+          evaluated_count++;
           if (scm_is_integer (forced_page_count))
             cur = space_systems_on_n_pages (i, page_count, first_page_num);
           else
@@ -187,7 +200,16 @@ Optimal_page_breaking::solve ()
 
           if (min_p_count > page_count)
             continue;
-          else if (scm_is_integer (forced_page_count))
+
+          if (min_demerits (i) >= max (best.demerits_,
+                                       best_demerits_for_this_sys_count))
+            {
+              pruned_count++;
+              continue;
+            }
+
+          evaluated_count++;
+          if (scm_is_integer (forced_page_count))
             cur = space_systems_on_n_pages (i, page_count, first_page_num);
           else
             cur = space_systems_on_best_pages (i, first_page_num);
@@ -213,6 +235,9 @@ Optimal_page_breaking::solve ()
         break;
     }
 
+  debug_output (_f ("Spaced %d line configurations on pages, skipped %d",
+                     evaluated_count, pruned_count));
+
   message (_ ("Drawing systems..."));
   break_into_pieces (0, end, best_division);
   SCM lines = systems ();
@@ -24,6 +24,7 @@
 #include "interval.hh"
 #include "ly-module.hh"
 #include "main.hh"
+#include "markup-cache.hh"
 #include "output-def.hh"
 #include "scm-hash.hh"
 #include "warn.hh"
@@ -112,14 +113,20 @@ Output_def::get_dimension (SCM s) const
 SCM
 Output_def::lookup_variable (SCM sym) const
 {
-  SCM var = ly_module_lookup (scope_, sym);
-  if (SCM_VARIABLEP (var) && !SCM_UNBNDP (SCM_VARIABLE_REF (var)))
-    return SCM_VARIABLE_REF (var);
-
-  if (parent_)
-    return parent_->lookup_variable (sym);
+  SCM val = SCM_UNDEFINED;
+  for (Output_def const *def = this; def; def = def->parent_)
+    {
+      SCM var = ly_module_lookup (def->scope_, sym);
+      if (SCM_VARIABLEP (var) && !SCM_UNBNDP (SCM_VARIABLE_REF (var)))
+        {
+          val = SCM_VARIABLE_REF (var);
+          break;
+        }
+    }
 
-  return SCM_UNDEFINED;
+  if (Markup_cache::is_recording ())
+    Markup_cache::note_variable_read (self_scm (), sym, val);
+  return val;
 }
 
 SCM
@@ -1418,6 +1418,38 @@ Page_breaking::pack_systems_on_least_pages (vsize configuration, vsize first_pag
   return finalize_spacing_result (configuration, res);
 }
 
+/* A lower bound for the demerits of any spacing of CONFIGURATION, as
+   computed by finalize_spacing_result ().  The line forces and break
+   penalties do not depend on the page breaks.  Page forces only add
+   to the demerits, so the page penalties are the only terms that can
+   lower them: every compressed line ends at most one page, which may
+   cost its page and turn penalties and two orphan penalties. */
+Real
+Page_breaking::min_demerits (vsize configuration)
+{
+  Real page_weighting = robust_scm2double (book_->paper_->c_variable ("page-spacing-weight"), 10);
+  if (page_weighting < 0)
+    return -infinity_f;
+
+  cache_line_details (configuration);
+
+  Real line_force = 0;
+  Real line_penalty = 0;
+  for (vsize i = 0; i < uncompressed_line_details_.size (); i++)
+    {
+      line_force += uncompressed_line_details_[i].force_ * uncompressed_line_details_[i].force_;
+      line_penalty += uncompressed_line_details_[i].break_penalty_;
+    }
+
+  Real page_demerits = 0;
+  for (vsize i = 0; i < cached_line_details_.size (); i++)
+    page_demerits += min (cached_line_details_[i].page_penalty_, 0.0)
+                     + min (cached_line_details_[i].turn_penalty_, 0.0)
+                     + 2 * min (orphan_penalty (), 0);
+
+  return line_force + line_penalty + page_demerits * page_weighting;
+}
+
 /* Calculate demerits and fix res.systems_per_page_ so that
    it refers to the original line numbers, not the ones given by compress_lines (). */
 Page_spacing_result
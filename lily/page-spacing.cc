@@ -142,6 +142,16 @@ Page_spacer::Page_spacer (vector<Line_details> const &lines, vsize first_page_nu
   max_page_count_ = 0;
   ragged_ = breaker->ragged ();
   ragged_last_ = breaker->is_last () && breaker->ragged_last ();
+
+  Real min_page_penalty = 0;
+  Real min_turn_penalty = 0;
+  for (vsize i = 0; i < lines_.size (); i++)
+    {
+      min_page_penalty = min (min_page_penalty, lines_[i].page_penalty_);
+      min_turn_penalty = min (min_turn_penalty, lines_[i].turn_penalty_);
+    }
+  min_penalty_ = min_page_penalty + min_turn_penalty
+                 + 2 * min (breaker->orphan_penalty (), 0);
 }
 
 Page_spacing_result
@@ -288,6 +298,12 @@ Page_spacer::resize (vsize page_count)
 // we don't want to constrain the number of pages that the solution has.  In this
 // case, the algorithm looks more like the page-turn-page-breaking algorithm.  But
 // the subproblems look similar for both, so we reuse this method.
+//
+// The demerits of a page are never less than those of the previous
+// node plus MIN_PENALTY_, since the spacing demerits are not negative.
+// So once the least demerits of the remaining previous nodes, plus
+// MIN_PENALTY_, are no better than the best demerits so far, no earlier
+// page start can win and we stop.  This does not change the result.
 bool
 Page_spacer::calc_subproblem (vsize page, vsize line)
 {
@@ -326,6 +342,16 @@ Page_spacer::calc_subproblem (vsize page, vsize line)
       else if (page > 0)
         prev = &state_.at (page_start - 1, page - 1);
 
+      if (prev && page_start < line)
+        {
+          // Without a page count, the first page may also start here.
+          Real rest = prev->min_demerits_;
+          if (page == VPOS)
+            rest = min (rest, Real (0));
+          if (rest + min_penalty_ >= cur.demerits_)
+            break;
+        }
+
       space.prepend_system (lines_[page_start]);
 
       bool overfull = (space.rod_height_ > paper_height
@@ -392,6 +418,15 @@ Page_spacer::calc_subproblem (vsize page, vsize line)
                         ly_symbol2scm ("force")))
         break;
     }
+
+  cur.min_demerits_ = cur.demerits_;
+  if (line > page_num)
+    {
+      Page_spacing_node const &before = page == VPOS
+                                        ? simple_state_[line - 1]
+                                        : state_.at (line - 1, page);
+      cur.min_demerits_ = min (cur.min_demerits_, before.min_demerits_);
+    }
   return !isinf (cur.demerits_);
 }
 
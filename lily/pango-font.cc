@@ -41,6 +41,7 @@
 #include "warn.hh"
 #include "all-font-metrics.hh"
 #include "program-option.hh"
+#include "raster-canvas.hh"
 #include "open-type-font.hh"
 
 #if HAVE_PANGO_FT2
@@ -82,6 +83,10 @@ Pango_font::~Pango_font ()
   pango_font_description_free (pango_description_);
   g_object_unref (context_);
   pango_attr_list_unref (attribute_list_);
+  for (map<string, FT_Face>::const_iterator i = physical_faces_.begin ();
+       i != physical_faces_.end (); i++)
+    if (i->second)
+      FT_Done_Face (i->second);
 }
 
 void
@@ -179,6 +184,70 @@ Pango_font::get_glyph_outline (size_t signed_idx) const
   return s;
 }
 
+/*
+  The face of the physical font PS_NAME that was registered while
+  making glyph strings, or 0.
+*/
+FT_Face
+Pango_font::physical_face (SCM ps_name) const
+{
+  string name = ly_scm2string (ps_name);
+  map<string, FT_Face>::const_iterator i = physical_faces_.find (name);
+  if (i != physical_faces_.end ())
+    return i->second;
+
+  FT_Face face = 0;
+  SCM entry = scm_hash_ref (physical_font_tab_, ps_name, SCM_BOOL_F);
+  if (scm_is_pair (entry))
+    {
+      string file_name = ly_scm2string (scm_car (entry));
+      if (FT_New_Face (freetype2_library, file_name.c_str (),
+                       scm_to_int (scm_cadr (entry)), &face))
+        {
+          warning (_f ("cannot open font file %s", file_name.c_str ()));
+          face = 0;
+        }
+    }
+  physical_faces_[name] = face;
+  return face;
+}
+
+static void
+fill_face_glyph (Raster_canvas *canvas, FT_Face face, SCM char_id,
+                 Real size, Offset origin)
+{
+  size_t idx = scm_is_integer (char_id)
+               ? scm_to_size_t (char_id)
+               : ly_FT_name_to_index (face, ly_scm2string (char_id));
+  if (idx)
+    canvas->fill_glyph (face, idx, size / face->units_per_EM, origin);
+}
+
+/*
+  Draw the glyph CHAR_ID of a glyph-string expression for the physical
+  font PS_NAME on CANVAS, with an em size of SIZE.  CHAR_ID is a glyph
+  name or a CID.  Glyphs that Pango took from a fallback font are drawn
+  from that font's face; the primary face is only used if PS_NAME is
+  unknown.
+*/
+void
+Pango_font::fill_glyph (Raster_canvas *canvas, SCM ps_name, SCM char_id,
+                        Real size, Offset origin) const
+{
+  if (FT_Face face = physical_face (ps_name))
+    {
+      fill_face_glyph (canvas, face, char_id, size, origin);
+      return;
+    }
+
+  PangoFont *font = pango_context_load_font (context_, pango_description_);
+  PangoFcFont *fcfont = PANGO_FC_FONT (font);
+  FT_Face face = pango_fc_font_lock_face (fcfont);
+  fill_face_glyph (canvas, face, char_id, size, origin);
+  pango_fc_font_unlock_face (fcfont);
+  g_object_unref (font);
+}
+
 Stencil
 Pango_font::pango_item_string_stencil (PangoGlyphItem const *glyph_item) const
 {
@@ -38,6 +38,7 @@ LY_DEFINE (ly_make_paper_outputter, "ly:make-paper-outputter",
   if (scm_is_string (port_name))
     output_name = ly_scm2string (port_name);
 
+  report_memory ("output");
   message (_f ("Layout output to `%s'...",
                output_name.c_str ()));
 
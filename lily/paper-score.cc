@@ -21,6 +21,7 @@
 
 #include "all-font-metrics.hh"
 #include "book.hh"
+#include "gc-pacing.hh"
 #include "international.hh"
 #include "main.hh"
 #include "misc.hh"
@@ -113,6 +114,7 @@ Paper_score::calc_breaking ()
   Constrained_breaking algorithm (this);
   vector<Column_x_positions> sol;
 
+  report_memory ("line breaking");
   message (_ ("Calculating line breaks...") + " ");
 
   int system_count = robust_scm2int (layout ()->c_variable ("system-count"), 0);
@@ -129,6 +131,8 @@ Paper_score::process ()
                     system_->element_count (),
                     system_->spanner_count ()));
 
+  gc_pacing_before_layout ();
+  report_memory ("preprocessing");
   message (_ ("Preprocessing graphical objects..."));
 
   system_->pre_processing ();
@@ -153,6 +157,7 @@ Paper_score::get_paper_systems ()
     {
       vector<Column_x_positions> breaking = calc_breaking ();
       system_->break_into_pieces (breaking);
+      report_memory ("drawing systems");
       message (_ ("Drawing systems...") + " ");
       system_->do_break_substitution_and_fixup_refpoints ();
       paper_systems_ = system_->get_paper_systems ();
@@ -40,6 +40,31 @@ LY_DEFINE (ly_type1_2_pfa, "ly:type1->pfa",
   return pfa_scm;
 }
 
+LY_DEFINE (ly_type1_2_pdf_segments, "ly:type1->pdf-segments",
+           1, 0, 0, (SCM type1_file_name),
+           "Read the Type@tie{}1 font @var{type1-file-name}, in PFA or"
+           " PFB format, and return a list of its clear-text part, its"
+           " encrypted part in binary and its trailer, as strings."
+           "  This is the form in which PDF files embed Type@tie{}1"
+           " fonts.")
+{
+  LY_ASSERT_TYPE (scm_is_string, type1_file_name, 1);
+
+  string file_name = ly_scm2string (type1_file_name);
+
+  debug_output ("[" + file_name); // start message on a new line
+
+  vector<string> parts = type1_pdf_segments (gulp_file (file_name, 0));
+  SCM l = SCM_EOL;
+  for (vsize i = parts.size (); i--;)
+    l = scm_cons (scm_from_latin1_stringn (parts[i].data (), parts[i].size ()),
+                  l);
+
+  debug_output ("]", false);
+
+  return l;
+}
+
 LY_DEFINE (ly_otf_2_cff, "ly:otf->cff",
            1, 1, 0, (SCM otf_file_name, SCM idx),
            "Convert the contents of an OTF file to a CFF file,"
@@ -17,6 +17,7 @@
   along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <cctype>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -90,3 +91,91 @@ pfb2pfa (const vector<char> &pfb)
 
   return out;
 }
+
+static int
+hex_digit_value (char c)
+{
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/*
+  Split a Type 1 font in PFB or PFA format into the clear-text part,
+  the encrypted part in binary and the trailer of zeros, which is how
+  PDF embeds Type 1 fonts.
+*/
+vector<string>
+type1_pdf_segments (const vector<char> &type1)
+{
+  vector<string> parts (3);
+  if (type1.empty ())
+    return parts;
+
+  if (static_cast<Byte>(type1[0]) == 128)
+    {
+      bool seen_binary = false;
+      vector<char>::const_iterator p = type1.begin ();
+      while (p + 6 <= type1.end () && static_cast<Byte>(*p) == 128)
+        {
+          Byte type = static_cast<Byte>(p[1]);
+          if (type == 3)
+            break;
+
+          size_t seglen = static_cast<Byte>(p[2]);
+          seglen |= (static_cast<Byte>(p[3]) << 8);
+          seglen |= (static_cast<Byte>(p[4]) << 16);
+          seglen |= (static_cast<Byte>(p[5]) << 24);
+          p += 6;
+          if ((p + seglen) > type1.end ())
+            {
+              error (_ ("Segment length of the Type 1 (PFB) font is too long."));
+              break;
+            }
+
+          if (type == 2)
+            seen_binary = true;
+          parts[type == 2 ? 1 : seen_binary ? 2 : 0].append (p, p + seglen);
+          p += seglen;
+        }
+      return parts;
+    }
+
+  string pfa (type1.begin (), type1.end ());
+  size_t start = pfa.find ("eexec");
+  if (start == string::npos)
+    {
+      parts[0] = pfa;
+      return parts;
+    }
+  start += 5;
+  while (start < pfa.size () && isspace (static_cast<Byte>(pfa[start])))
+    start++;
+
+  /* The trailer is 512 zeros in lines of 64, then cleartomark.  */
+  size_t end = pfa.find (string (64, '0'), start);
+  if (end == string::npos)
+    end = pfa.size ();
+
+  parts[0] = pfa.substr (0, start);
+  int high = -1;
+  for (size_t i = start; i < end; i++)
+    {
+      int v = hex_digit_value (pfa[i]);
+      if (v < 0)
+        continue;
+      if (high < 0)
+        high = v;
+      else
+        {
+          parts[1] += char ((high << 4) | v);
+          high = -1;
+        }
+    }
+  parts[2] = pfa.substr (end);
+  return parts;
+}
@@ -20,6 +20,7 @@
 #include "profile.hh"
 #include "protected-scm.hh"
 
+Protected_scm callback_time_table;
 Protected_scm context_property_lookup_table;
 Protected_scm grob_property_lookup_table;
 Protected_scm prob_property_lookup_table;
@@ -28,8 +29,14 @@ LY_DEFINE (ly_property_lookup_stats, "ly:property-lookup-stats",
            1, 0, 0, (SCM sym),
            "Return hash table with a property access corresponding to"
            " @var{sym}.  Choices are @code{prob}, @code{grob}, and"
-           " @code{context}.")
+           " @code{context}.  With @code{callback}, the table maps"
+           " @code{@var{grob-name}.@var{property}} to the number of"
+           " callback invocations and their total time in seconds,"
+           " nested callbacks included.")
 {
+  if (callback_time_table.is_bound ()
+      && scm_is_eq (sym, ly_symbol2scm ("callback")))
+    return callback_time_table;
   if (context_property_lookup_table.is_bound ()
       && scm_is_eq (sym, ly_symbol2scm ("context")))
     return context_property_lookup_table;
@@ -61,3 +68,23 @@ note_property_access (Protected_scm *table, SCM sym)
   int count = scm_to_int (scm_cdr (hashhandle)) + 1;
   scm_set_cdr_x (hashhandle, scm_from_int (count));
 }
+
+void
+note_callback_time (SCM key, Real seconds)
+{
+  if (!callback_time_table.is_bound ())
+    callback_time_table = scm_c_make_hash_table (259);
+
+  SCM handle = scm_hashq_get_handle (callback_time_table, key);
+  if (scm_is_false (handle))
+    {
+      scm_hashq_set_x (callback_time_table, key,
+                       scm_cons (scm_from_int (0), scm_from_double (0.0)));
+      handle = scm_hashq_get_handle (callback_time_table, key);
+    }
+
+  SCM entry = scm_cdr (handle);
+  scm_set_car_x (entry, scm_from_int (scm_to_int (scm_car (entry)) + 1));
+  scm_set_cdr_x (entry, scm_from_double (scm_to_double (scm_cdr (entry))
+                                         + seconds));
+}
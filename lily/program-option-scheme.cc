@@ -31,6 +31,7 @@ using namespace std;
 #include "warn.hh"
 #include "lily-imports.hh"
 #include "protected-scm.hh"
+#include "pure-property-cache.hh"
 
 bool debug_skylines;
 bool debug_property_callbacks;
@@ -62,6 +63,11 @@ internal_set_option (SCM var,
       profile_property_accesses = valbool;
       val = val_scm_bool;
     }
+  else if (varstr == "cache-pure-properties")
+    {
+      Pure_property_cache::enabled_ = valbool;
+      val = val_scm_bool;
+    }
   else if (varstr == "protected-scheme-parsing")
     {
       parse_protect_global = valbool;
@@ -0,0 +1,134 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "pure-property-cache.hh"
+
+bool Pure_property_cache::enabled_ = true;
+long Pure_property_cache::hits_ = 0;
+long Pure_property_cache::misses_ = 0;
+
+Pure_property_cache::Pure_property_cache ()
+{
+  count_ = 0;
+}
+
+/*
+  Find the slot for the key, or the empty slot where it would go.
+  Symbols are interned, so their address identifies them.
+*/
+vsize
+Pure_property_cache::slot (SCM sym, int start, int end) const
+{
+  vsize mask = entries_.size () - 1;
+  size_t h = size_t (SCM_UNPACK (sym)) >> 3;
+  h = h * 31 + size_t (start);
+  h = h * 31 + size_t (end);
+  h ^= h >> 16;
+
+  for (vsize i = h & mask;; i = (i + 1) & mask)
+    {
+      Entry const &e = entries_[i];
+      if (SCM_UNBNDP (e.sym_)
+          || (scm_is_eq (e.sym_, sym) && e.start_ == start && e.end_ == end))
+        return i;
+    }
+}
+
+void
+Pure_property_cache::grow ()
+{
+  vector<Entry> old;
+  old.swap (entries_);
+
+  Entry empty;
+  empty.sym_ = SCM_UNDEFINED;
+  empty.start_ = empty.end_ = 0;
+  empty.value_ = SCM_UNDEFINED;
+  entries_.resize (old.empty () ? 8 : 2 * old.size (), empty);
+
+  for (vsize i = 0; i < old.size (); i++)
+    if (!SCM_UNBNDP (old[i].sym_))
+      entries_[slot (old[i].sym_, old[i].start_, old[i].end_)] = old[i];
+}
+
+/*
+  Return SCM_UNDEFINED if there is no entry.
+*/
+SCM
+Pure_property_cache::get (SCM sym, int start, int end) const
+{
+  if (!count_)
+    {
+      misses_++;
+      return SCM_UNDEFINED;
+    }
+
+  Entry const &e = entries_[slot (sym, start, end)];
+  if (SCM_UNBNDP (e.sym_))
+    {
+      misses_++;
+      return SCM_UNDEFINED;
+    }
+
+  hits_++;
+  return e.value_;
+}
+
+void
+Pure_property_cache::set (SCM sym, int start, int end, SCM value)
+{
+  if (!enabled_)
+    return;
+
+  /* Keep the load factor below 3/4.  */
+  if (4 * (count_ + 1) > 3 * entries_.size ())
+    grow ();
+
+  Entry &e = entries_[slot (sym, start, end)];
+  if (SCM_UNBNDP (e.sym_))
+    {
+      e.sym_ = sym;
+      e.start_ = start;
+      e.end_ = end;
+      count_++;
+    }
+  e.value_ = value;
+}
+
+void
+Pure_property_cache::mark () const
+{
+  for (vsize i = 0; i < entries_.size (); i++)
+    if (!SCM_UNBNDP (entries_[i].sym_))
+      {
+        scm_gc_mark (entries_[i].sym_);
+        scm_gc_mark (entries_[i].value_);
+      }
+}
+
+LY_DEFINE (ly_pure_property_cache_stats, "ly:pure-property-cache-stats",
+           0, 0, 0, (),
+           "Return an alist with the number of @code{hits} and"
+           " @code{misses} of the pure property caches of spanners.")
+{
+  return scm_list_2 (scm_cons (ly_symbol2scm ("hits"),
+                               scm_from_long (Pure_property_cache::hits_)),
+                     scm_cons (ly_symbol2scm ("misses"),
+                               scm_from_long (Pure_property_cache::misses_)));
+}
@@ -0,0 +1,692 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "raster-canvas.hh"
+
+#include "config.hh"
+
+#include <cmath>
+#include <cstdio>
+#if HAVE_LIBZ
+#include <zlib.h>
+#endif
+
+#include FT_OUTLINE_H
+
+#include "international.hh"
+#include "warn.hh"
+
+Raster_canvas::Raster_canvas (int width, int height,
+                              PangoMatrix const &device)
+{
+  width_ = max (width, 1);
+  height_ = max (height, 1);
+  pixels_.resize (vsize (width_) * height_ * 3, 255);
+  transforms_.push_back (device);
+
+  Color black = {0.0, 0.0, 0.0};
+  colors_.push_back (black);
+}
+
+void
+Raster_canvas::push_transform (PangoMatrix const &m)
+{
+  PangoMatrix t = transforms_.back ();
+  pango_matrix_multiply (&t, &m);
+  transforms_.push_back (t);
+}
+
+void
+Raster_canvas::pop_transform ()
+{
+  if (transforms_.size () > 1)
+    transforms_.pop_back ();
+}
+
+void
+Raster_canvas::push_color (Real r, Real g, Real b)
+{
+  Color c = {r, g, b};
+  colors_.push_back (c);
+}
+
+void
+Raster_canvas::pop_color ()
+{
+  if (colors_.size () > 1)
+    colors_.pop_back ();
+}
+
+Offset
+Raster_canvas::device (Offset p) const
+{
+  double x = p[X_AXIS];
+  double y = p[Y_AXIS];
+  pango_matrix_transform_point (&transforms_.back (), &x, &y);
+  return Offset (x, y);
+}
+
+/*
+  The largest allowed deviation of a flattened curve from the real
+  one, in user coordinates; a quarter pixel.
+*/
+Real
+Raster_canvas::flatness () const
+{
+  PangoMatrix const &m = transforms_.back ();
+  Real det = fabs (m.xx * m.yy - m.xy * m.yx);
+  return det > 0 ? 0.25 / sqrt (det) : 0.25;
+}
+
+void
+Raster_canvas::move_to (Offset p)
+{
+  path_.push_back (vector<Offset> (1, p));
+  closed_.push_back (false);
+}
+
+/*
+  After closepath, drawing continues with a new subpath from the start
+  of the closed one.
+*/
+void
+Raster_canvas::continue_path ()
+{
+  if (closed_.back ())
+    move_to (path_.back ()[0]);
+}
+
+void
+Raster_canvas::line_to (Offset p)
+{
+  if (path_.empty ())
+    move_to (p);
+  else
+    {
+      continue_path ();
+      path_.back ().push_back (p);
+    }
+}
+
+void
+Raster_canvas::curve_to (Offset c1, Offset c2, Offset end)
+{
+  if (path_.empty ())
+    move_to (c1);
+  continue_path ();
+
+  Offset start = path_.back ().back ();
+
+  /*
+    Uniform subdivision; the deviation of n segments is bounded by
+    3/4 of the largest second difference of the control points,
+    divided by n^2.
+  */
+  Real dd = max ((start - c1 * 2.0 + c2).length (),
+                 (c1 - c2 * 2.0 + end).length ());
+  int n = int (ceil (sqrt (0.75 * dd / flatness ())));
+  n = min (max (n, 1), 1000);
+
+  for (int i = 1; i <= n; i++)
+    {
+      Real t = Real (i) / n;
+      Real u = 1 - t;
+      path_.back ().push_back (start * (u * u * u)
+                               + c1 * (3 * u * u * t)
+                               + c2 * (3 * u * t * t)
+                               + end * (t * t * t));
+    }
+}
+
+void
+Raster_canvas::close_path ()
+{
+  if (path_.empty ())
+    return;
+
+  closed_.back () = true;
+}
+
+/*
+  Accumulate the signed area that the edge from P0 to P1 covers in
+  each cell of ACC, a WIDTH x HEIGHT row-major grid.  The coverage of
+  a pixel is the running sum of its row up to and including it.
+*/
+static void
+accumulate_edge (vector<float> *acc, int width, int height,
+                 Offset p0, Offset p1)
+{
+  if (p0[Y_AXIS] == p1[Y_AXIS])
+    return;
+
+  Real dir = 1.0;
+  if (p0[Y_AXIS] > p1[Y_AXIS])
+    {
+      swap (p0, p1);
+      dir = -1.0;
+    }
+
+  Real dxdy = (p1[X_AXIS] - p0[X_AXIS]) / (p1[Y_AXIS] - p0[Y_AXIS]);
+  Real x = p0[X_AXIS];
+  if (p0[Y_AXIS] < 0)
+    x -= p0[Y_AXIS] * dxdy;
+
+  /* The last column is a sink for edges right of the area.  */
+  Real x_max = width - 2;
+
+  int y_start = max (int (floor (p0[Y_AXIS])), 0);
+  int y_end = min (int (ceil (p1[Y_AXIS])), height);
+  for (int y = y_start; y < y_end; y++)
+    {
+      float *row = &(*acc)[vsize (y) * width];
+      Real dy = min (Real (y + 1), p1[Y_AXIS]) - max (Real (y), p0[Y_AXIS]);
+      Real x_next = x + dxdy * dy;
+      Real d = dy * dir;
+
+      Real x0 = min (max (min (x, x_next), 0.0), x_max);
+      Real x1 = min (max (max (x, x_next), 0.0), x_max);
+      Real x0_floor = floor (x0);
+      int x0i = int (x0_floor);
+      Real x1_ceil = ceil (x1);
+      int x1i = int (x1_ceil);
+
+      if (x1i <= x0i + 1)
+        {
+          Real xm = 0.5 * (x0 + x1) - x0_floor;
+          row[x0i] += float (d - d * xm);
+          row[x0i + 1] += float (d * xm);
+        }
+      else
+        {
+          Real s = 1.0 / (x1 - x0);
+          Real x0f = x0 - x0_floor;
+          Real a0 = 0.5 * s * (1 - x0f) * (1 - x0f);
+          Real x1f = x1 - x1_ceil + 1;
+          Real am = 0.5 * s * x1f * x1f;
+
+          row[x0i] += float (d * a0);
+          if (x1i == x0i + 2)
+            row[x0i + 1] += float (d * (1 - a0 - am));
+          else
+            {
+              Real a1 = s * (1.5 - x0f);
+              row[x0i + 1] += float (d * (a1 - a0));
+              for (int xi = x0i + 2; xi < x1i - 1; xi++)
+                row[xi] += float (d * s);
+              Real a2 = a1 + (x1i - x0i - 3) * s;
+              row[x1i - 1] += float (d * (1 - a2 - am));
+            }
+          row[x1i] += float (d * am);
+        }
+
+      x = x_next;
+    }
+}
+
+static Real
+signed_area (vector<Offset> const &poly)
+{
+  Real a = 0.0;
+  for (vsize i = 0; i < poly.size (); i++)
+    {
+      Offset const &p = poly[i];
+      Offset const &q = poly[(i + 1) % poly.size ()];
+      a += p[X_AXIS] * q[Y_AXIS] - q[X_AXIS] * p[Y_AXIS];
+    }
+  return a / 2;
+}
+
+/*
+  Fill POLYS with the current color.  If ORIENT is set, all polygons
+  are first turned the same way, so overlapping pieces of one stroke
+  merge instead of cancelling each other.
+*/
+void
+Raster_canvas::fill_polygons (vector<vector<Offset> > const &polys,
+                              bool orient)
+{
+  vector<vector<Offset> > dev;
+  Real x_min = infinity_f;
+  Real x_max = -infinity_f;
+  Real y_min = infinity_f;
+  Real y_max = -infinity_f;
+
+  for (vsize i = 0; i < polys.size (); i++)
+    {
+      if (polys[i].size () < 3)
+        continue;
+
+      dev.push_back (vector<Offset> ());
+      vector<Offset> &d = dev.back ();
+      for (vsize j = 0; j < polys[i].size (); j++)
+        {
+          Offset p = device (polys[i][j]);
+          if (isinf (p[X_AXIS]) || isnan (p[X_AXIS])
+              || isinf (p[Y_AXIS]) || isnan (p[Y_AXIS]))
+            continue;
+          d.push_back (p);
+          x_min = min (x_min, p[X_AXIS]);
+          x_max = max (x_max, p[X_AXIS]);
+          y_min = min (y_min, p[Y_AXIS]);
+          y_max = max (y_max, p[Y_AXIS]);
+        }
+      if (orient && signed_area (d) < 0)
+        reverse (d);
+    }
+
+  if (dev.empty ())
+    return;
+
+  int left = max (int (floor (x_min)), 0);
+  int right = min (int (ceil (x_max)), width_);
+  int top = max (int (floor (y_min)), 0);
+  int bottom = min (int (ceil (y_max)), height_);
+  if (left >= right || top >= bottom)
+    return;
+
+  int w = right - left + 2;
+  int h = bottom - top;
+  vector<float> acc (vsize (w) * h, 0.0f);
+  Offset origin (left, top);
+
+  for (vsize i = 0; i < dev.size (); i++)
+    for (vsize j = 0; j < dev[i].size (); j++)
+      accumulate_edge (&acc, w, h, dev[i][j] - origin,
+                       dev[i][(j + 1) % dev[i].size ()] - origin);
+
+  Color const &c = colors_.back ();
+  Real rgb[3] = {255 * c.r_, 255 * c.g_, 255 * c.b_};
+  for (int y = 0; y < h; y++)
+    {
+      float const *row = &acc[vsize (y) * w];
+      unsigned char *pix = &pixels_[(vsize (top + y) * width_ + left) * 3];
+      Real sum = 0.0;
+      for (int x = 0; x < right - left; x++, pix += 3)
+        {
+          sum += row[x];
+          Real cover = min (fabs (sum), 1.0);
+          if (cover < 1.0 / 512)
+            continue;
+
+          for (int k = 0; k < 3; k++)
+            pix[k] = (unsigned char) (pix[k] * (1 - cover)
+                                      + rgb[k] * cover + 0.5);
+        }
+    }
+}
+
+static void
+add_circle (vector<vector<Offset> > *polys, Offset center, Real radius,
+            Real flatness)
+{
+  int n = int (ceil (M_PI * sqrt (radius / flatness)));
+  n = min (max (n, 8), 256);
+
+  polys->push_back (vector<Offset> ());
+  for (int i = 0; i < n; i++)
+    polys->back ().push_back (center
+                              + offset_directed (360.0 * i / n) * radius);
+}
+
+/*
+  Outline the stroke of the polyline PTS with polygons, appended to
+  OUT.  Joins and caps follow the PostScript semantics, with the
+  default miter limit of 10.
+*/
+void
+Raster_canvas::stroke_polygons (vector<Offset> const &input, bool closed,
+                                Real thickness, int cap, int join,
+                                vector<vector<Offset> > *out) const
+{
+  vector<Offset> pts;
+  for (vsize i = 0; i < input.size (); i++)
+    if (pts.empty () || (input[i] - pts.back ()).length () > 1e-9)
+      pts.push_back (input[i]);
+  if (closed && pts.size () > 1
+      && (pts[0] - pts.back ()).length () <= 1e-9)
+    pts.pop_back ();
+
+  Real r = thickness / 2;
+  if (input.size () < 2 || r <= 0)
+    return;
+
+  if (pts.size () == 1)
+    {
+      if (cap == ROUND_CAP)
+        add_circle (out, pts[0], r, flatness ());
+      else if (cap == SQUARE_CAP)
+        {
+          vector<Offset> sq;
+          sq.push_back (pts[0] + Offset (-r, -r));
+          sq.push_back (pts[0] + Offset (r, -r));
+          sq.push_back (pts[0] + Offset (r, r));
+          sq.push_back (pts[0] + Offset (-r, r));
+          out->push_back (sq);
+        }
+      return;
+    }
+
+  vsize segments = closed ? pts.size () : pts.size () - 1;
+  for (vsize i = 0; i < segments; i++)
+    {
+      Offset p = pts[i];
+      Offset q = pts[(i + 1) % pts.size ()];
+      Offset dir = (q - p).direction ();
+      Offset normal (-dir[Y_AXIS], dir[X_AXIS]);
+
+      if (!closed && cap == SQUARE_CAP)
+        {
+          if (i == 0)
+            p -= dir * r;
+          if (i == segments - 1)
+            q += dir * r;
+        }
+
+      vector<Offset> quad;
+      quad.push_back (p + normal * r);
+      quad.push_back (q + normal * r);
+      quad.push_back (q - normal * r);
+      quad.push_back (p - normal * r);
+      out->push_back (quad);
+    }
+
+  vsize first_join = closed ? 0 : 1;
+  vsize last_join = closed ? pts.size () : pts.size () - 1;
+  for (vsize i = first_join; i < last_join; i++)
+    {
+      Offset v = pts[i];
+      if (join == ROUND_JOIN)
+        {
+          add_circle (out, v, r, flatness ());
+          continue;
+        }
+
+      Offset prev = pts[(i + pts.size () - 1) % pts.size ()];
+      Offset next = pts[(i + 1) % pts.size ()];
+      Offset d1 = (v - prev).direction ();
+      Offset d2 = (next - v).direction ();
+      Offset n1 (-d1[Y_AXIS], d1[X_AXIS]);
+      Offset n2 (-d2[Y_AXIS], d2[X_AXIS]);
+
+      /* The outer side of a left turn is on the right.  */
+      Real side = (cross_product (d1, d2) > 0) ? -1 : 1;
+      Real cos_angle = dot_product (n1, n2);
+
+      vector<Offset> piece;
+      piece.push_back (v);
+      piece.push_back (v + n1 * (side * r));
+      if (join == MITER_JOIN && 1 + cos_angle >= 0.02)
+        piece.push_back (v + (n1 + n2) * (side * r / (1 + cos_angle)));
+      piece.push_back (v + n2 * (side * r));
+      out->push_back (piece);
+    }
+
+  if (!closed && cap == ROUND_CAP)
+    {
+      add_circle (out, pts[0], r, flatness ());
+      add_circle (out, pts.back (), r, flatness ());
+    }
+}
+
+void
+Raster_canvas::fill ()
+{
+  fill_polygons (path_, false);
+  path_.clear ();
+  closed_.clear ();
+}
+
+void
+Raster_canvas::stroke (Real thickness, int cap, int join)
+{
+  /* Like PostScript, draw zero-width lines one pixel wide.  */
+  thickness = max (thickness, 4 * flatness ());
+
+  vector<vector<Offset> > pieces;
+  for (vsize i = 0; i < path_.size (); i++)
+    stroke_polygons (path_[i], closed_[i], thickness, cap, join, &pieces);
+
+  fill_polygons (pieces, true);
+  path_.clear ();
+  closed_.clear ();
+}
+
+void
+Raster_canvas::fill_and_stroke (Real thickness, int cap, int join)
+{
+  vector<vector<Offset> > path = path_;
+  vector<bool> closed = closed_;
+  fill ();
+  path_ = path;
+  closed_ = closed;
+  stroke (thickness, cap, join);
+}
+
+struct Glyph_outline_sink
+{
+  Raster_canvas *canvas_;
+  Real scale_;
+  Offset origin_;
+  Offset last_;
+
+  Offset point (FT_Vector const *v) const
+  {
+    return origin_ + Offset (Real (v->x), Real (v->y)) * scale_;
+  }
+};
+
+static int
+outline_move_to (FT_Vector const *to, void *user)
+{
+  Glyph_outline_sink *sink = (Glyph_outline_sink *) user;
+  sink->last_ = sink->point (to);
+  sink->canvas_->move_to (sink->last_);
+  return 0;
+}
+
+static int
+outline_line_to (FT_Vector const *to, void *user)
+{
+  Glyph_outline_sink *sink = (Glyph_outline_sink *) user;
+  sink->last_ = sink->point (to);
+  sink->canvas_->line_to (sink->last_);
+  return 0;
+}
+
+static int
+outline_conic_to (FT_Vector const *control, FT_Vector const *to, void *user)
+{
+  Glyph_outline_sink *sink = (Glyph_outline_sink *) user;
+  Offset c = sink->point (control);
+  Offset end = sink->point (to);
+  sink->canvas_->curve_to (sink->last_ + (c - sink->last_) * (2.0 / 3),
+                           end + (c - end) * (2.0 / 3),
+                           end);
+  sink->last_ = end;
+  return 0;
+}
+
+static int
+outline_cubic_to (FT_Vector const *c1, FT_Vector const *c2,
+                  FT_Vector const *to, void *user)
+{
+  Glyph_outline_sink *sink = (Glyph_outline_sink *) user;
+  sink->last_ = sink->point (to);
+  sink->canvas_->curve_to (sink->point (c1), sink->point (c2), sink->last_);
+  return 0;
+}
+
+/*
+  Fill glyph IDX of FACE.  SCALE converts font units to user
+  coordinates.
+*/
+void
+Raster_canvas::fill_glyph (FT_Face face, size_t idx, Real scale,
+                           Offset origin)
+{
+  if (FT_Load_Glyph (face, FT_UInt (idx), FT_LOAD_NO_SCALE)
+      || face->glyph->format != FT_GLYPH_FORMAT_OUTLINE)
+    return;
+
+  FT_Outline_Funcs funcs;
+  funcs.move_to = outline_move_to;
+  funcs.line_to = outline_line_to;
+  funcs.conic_to = outline_conic_to;
+  funcs.cubic_to = outline_cubic_to;
+  funcs.shift = 0;
+  funcs.delta = 0;
+
+  Glyph_outline_sink sink;
+  sink.canvas_ = this;
+  sink.scale_ = scale;
+  sink.origin_ = origin;
+
+  path_.clear ();
+  closed_.clear ();
+  FT_Outline_Decompose (&face->glyph->outline, &funcs, &sink);
+  fill ();
+}
+
+/*
+  PNG output.
+*/
+
+static unsigned long
+crc32_update (unsigned long crc, unsigned char const *data, vsize len)
+{
+  static unsigned long table[256];
+  static bool table_done = false;
+  if (!table_done)
+    {
+      for (unsigned long n = 0; n < 256; n++)
+        {
+          unsigned long c = n;
+          for (int k = 0; k < 8; k++)
+            c = (c & 1) ? 0xedb88320UL ^ (c >> 1) : c >> 1;
+          table[n] = c;
+        }
+      table_done = true;
+    }
+
+  crc ^= 0xffffffffUL;
+  for (vsize i = 0; i < len; i++)
+    crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+  return crc ^ 0xffffffffUL;
+}
+
+static void
+append_u32 (string *s, unsigned long v)
+{
+  *s += char ((v >> 24) & 0xff);
+  *s += char ((v >> 16) & 0xff);
+  *s += char ((v >> 8) & 0xff);
+  *s += char (v & 0xff);
+}
+
+static void
+write_chunk (FILE *out, char const *type, string const &data)
+{
+  string chunk;
+  append_u32 (&chunk, data.size ());
+  chunk += type;
+  chunk += data;
+  append_u32 (&chunk,
+              crc32_update (0, (unsigned char const *) chunk.data () + 4,
+                            chunk.size () - 4));
+  fwrite (chunk.data (), 1, chunk.size (), out);
+}
+
+/*
+  Wrap DATA in a zlib stream.  Without zlib, use uncompressed deflate
+  blocks.
+*/
+static string
+zlib_stream (string const &data)
+{
+#if HAVE_LIBZ
+  uLongf len = compressBound (data.size ());
+  vector<Bytef> buf (len);
+  if (compress2 (&buf[0], &len, (Bytef const *) data.data (), data.size (),
+                 Z_BEST_COMPRESSION) == Z_OK)
+    return string ((char const *) &buf[0], len);
+#endif
+
+  string out ("\x78\x01", 2);
+  unsigned long a = 1;
+  unsigned long b = 0;
+  for (vsize i = 0; i < data.size (); i++)
+    {
+      a = (a + (unsigned char) data[i]) % 65521;
+      b = (b + a) % 65521;
+    }
+
+  vsize pos = 0;
+  do
+    {
+      vsize len = min (data.size () - pos, vsize (65535));
+      bool last = pos + len == data.size ();
+      out += char (last ? 1 : 0);
+      out += char (len & 0xff);
+      out += char (len >> 8);
+      out += char (~len & 0xff);
+      out += char ((~len >> 8) & 0xff);
+      out.append (data, pos, len);
+      pos += len;
+    }
+  while (pos < data.size ());
+
+  append_u32 (&out, (b << 16) | a);
+  return out;
+}
+
+bool
+Raster_canvas::write_png (string const &file_name) const
+{
+  FILE *out = fopen (file_name.c_str (), "wb");
+  if (!out)
+    {
+      warning (_f ("cannot open file: `%s'", file_name.c_str ()));
+      return false;
+    }
+
+  fwrite ("\x89PNG\r\n\x1a\n", 1, 8, out);
+
+  string header;
+  append_u32 (&header, width_);
+  append_u32 (&header, height_);
+  header += '\x08'; // bit depth
+  header += '\x02'; // RGB
+  header += string (3, '\0'); // compression, filter, interlace
+  write_chunk (out, "IHDR", header);
+
+  string raw;
+  raw.reserve (vsize (width_ * 3 + 1) * height_);
+  for (int y = 0; y < height_; y++)
+    {
+      raw += '\0'; // no filter
+      raw.append ((char const *) &pixels_[vsize (y) * width_ * 3],
+                  vsize (width_) * 3);
+    }
+  write_chunk (out, "IDAT", zlib_stream (raw));
+  write_chunk (out, "IEND", "");
+
+  bool ok = !ferror (out);
+  fclose (out);
+  return ok;
+}
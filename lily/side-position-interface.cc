@@ -236,6 +236,14 @@ Side_position_interface::aligned_side (Grob *me, Axis a, bool pure, int start, i
   else
     me->warning ("cannot find skylines - strange alignment will follow");
 
+  Real horizon_padding = robust_scm2double (me->get_maybe_pure_property ("horizon-padding", pure, start, end), 0.0);
+
+  // Supports outside this range cannot affect the distance (see
+  // Skyline::padded), so there is no need to copy and merge their
+  // skylines.  For large support sets, this is most of them.
+  Interval my_reach (my_dim.left (), my_dim.right ());
+  my_reach.widen (2 * horizon_padding);
+  bool skipped_support = false;
 
   vector<Box> boxes;
   vector<Skyline_pair> skyps;
@@ -280,13 +288,27 @@ Side_position_interface::aligned_side (Grob *me, Axis a, bool pure, int start, i
                // we assume horizontal spacing is always pure
                Real yc = a == X_AXIS
                          ? e->pure_relative_y_coordinate (common[Y_AXIS], start, end)
-                         : e->maybe_pure_coordinate (common[Y_AXIS], Y_AXIS, pure, start, end);
+                         : 0.0;
+               Skyline const &orig = (*unsmob<Skyline_pair> (sp))[dir];
+               bool stem_support = a == Y_AXIS
+                                   && has_interface<Stem> (e)
+                                   && to_boolean (me->get_maybe_pure_property ("add-stem-support", pure, start, end));
+               Real shift = a == X_AXIS ? yc : xc;
+               // A stem's minimum height extends over the whole line.
+               if (!stem_support
+                   && (orig.left () + shift > my_reach[RIGHT]
+                       || orig.right () + shift < my_reach[LEFT]))
+                 {
+                   skipped_support = skipped_support || !orig.is_empty ();
+                   continue;
+                 }
+
+               if (a == Y_AXIS)
+                 yc = e->maybe_pure_coordinate (common[Y_AXIS], Y_AXIS, pure, start, end);
                Skyline_pair copy = *unsmob<Skyline_pair> (sp);
-               if (a == Y_AXIS
-                   && has_interface<Stem> (e)
-                   && to_boolean (me->get_maybe_pure_property ("add-stem-support", pure, start, end)))
+               if (stem_support)
                  copy[dir].set_minimum_height (copy[dir].max_height ());
-               copy.shift (a == X_AXIS ? yc : xc);
+               copy.shift (shift);
                copy.raise (a == X_AXIS ? xc : yc);
                skyps.push_back (copy);
              }
@@ -324,14 +346,14 @@ Side_position_interface::aligned_side (Grob *me, Axis a, bool pure, int start, i
   // One could even imagine the two interfaces merged, as the only
   // difference is that in self-alignment-interface we align on the parent
   // where as here we align on a group of grobs.
-  if (dim.is_empty ())
+  if (dim.is_empty () && !skipped_support)
     {
       dim = Skyline (dim.direction ());
       dim.set_minimum_height (0.0);
     }
 
   Real ss = Staff_symbol_referencer::staff_space (me);
-  Real dist = dim.distance (my_dim, robust_scm2double (me->get_maybe_pure_property ("horizon-padding", pure, start, end), 0.0));
+  Real dist = dim.distance (my_dim, horizon_padding);
   Real total_off = !isinf (dist) ? dir * dist : 0.0;
 
   total_off += dir * ss * robust_scm2double (me->get_maybe_pure_property ("padding", pure, start, end), 0.0);
@@ -404,12 +404,12 @@ get_column_description (vector<Grob *> const &cols, vsize col_index, bool line_s
   return description;
 }
 
-vector<Real>
+vector<vector<Real> >
 get_line_forces (vector<Grob *> const &columns,
                  Real line_len, Real indent, bool ragged)
 {
   vector<vsize> breaks;
-  vector<Real> force;
+  vector<vector<Real> > force;
   vector<Grob *> non_loose;
   vector<Column_description> cols;
   SCM force_break = ly_symbol2scm ("force");
@@ -429,10 +429,11 @@ get_line_forces (vector<Grob *> const &columns,
       cols.push_back (get_column_description (non_loose, i, false));
     }
   breaks.push_back (cols.size ());
-  force.resize (breaks.size () * breaks.size (), infinity_f);
+  force.resize (breaks.size ());
 
   for (vsize b = 0; b + 1 < breaks.size (); b++)
     {
+      vector<Real> &line_force = force[b];
       cols[breaks[b]] = get_column_description (non_loose, breaks[b], true);
       vsize st = breaks[b];
 
@@ -460,16 +461,14 @@ get_line_forces (vector<Grob *> const &columns,
                 }
             }
           spacer.solve ((b == 0) ? line_len - indent : line_len, ragged);
-          force[b * breaks.size () + c] = spacer.force_penalty (ragged);
 
           if (!spacer.fits ())
             {
               if (c == b + 1)
-                force[b * breaks.size () + c] = -200000;
-              else
-                force[b * breaks.size () + c] = infinity_f;
+                line_force.push_back (-200000);
               break;
             }
+          line_force.push_back (spacer.force_penalty (ragged));
           if (end < cols.size () && scm_is_eq (cols[end].break_permission_, force_break))
             break;
         }
@@ -76,12 +76,43 @@ Simultaneous_music_iterator::construct_children ()
         {
           *tail = scm_cons (scm_iter, *tail);
           tail = SCM_CDRLOC (*tail);
+          schedule (mi, j);
         }
       else
         mi->quit ();
     }
 }
 
+bool
+Simultaneous_music_iterator::Child_later::operator () (Child const &a,
+                                                       Child const &b) const
+{
+  if (a.when_ != b.when_)
+    return a.when_ > b.when_;
+  return a.rank_ > b.rank_;
+}
+
+bool
+Simultaneous_music_iterator::rank_less (Child const &a, Child const &b)
+{
+  return a.rank_ < b.rank_;
+}
+
+void
+Simultaneous_music_iterator::schedule (Music_iterator *it, vsize rank)
+{
+  Child c;
+  c.iter_ = it;
+  c.rank_ = rank;
+  if (it->run_always ())
+    always_.push_back (c);
+  else
+    {
+      c.when_ = it->pending_moment ();
+      queue_.push (c);
+    }
+}
+
 // If we have some iterators with definite next moment and no of them
 // remain after processing, we take the iterators with indefinite next
 // moment along.  That makes sure that no Lyric_combine_music_iterator
@@ -90,22 +121,31 @@ Simultaneous_music_iterator::construct_children ()
 void
 Simultaneous_music_iterator::process (Moment until)
 {
-  SCM *proc = &children_list_;
   bool finite = !pending_moment ().main_part_.is_infinity ();
-  while (scm_is_pair (*proc))
+
+  // Only the iterators that are due are touched, so a moment in which
+  // a few of many voices have a note is cheap.
+  vector<Child> due;
+  due.swap (always_);
+  while (!queue_.empty () && queue_.top ().when_ <= until)
     {
-      Music_iterator *i = unsmob<Music_iterator> (scm_car (*proc));
+      due.push_back (queue_.top ());
+      queue_.pop ();
+    }
+  vector_sort (due, rank_less);
+
+  for (vsize j = 0; j < due.size (); j++)
+    {
+      Music_iterator *i = due[j].iter_;
       if (i->run_always () || i->pending_moment () == until)
         i->process (until);
       if (!i->ok ())
         {
           i->quit ();
-          *proc = scm_cdr (*proc);
+          children_list_ = scm_delq_x (i->self_scm (), children_list_);
         }
       else
-        {
-          proc = SCM_CDRLOC (*proc);
-        }
+        schedule (i, due[j].rank_);
     }
   // If there were definite-ended iterators and all of them died, take
   // the rest of the iterators along with them.  They have
@@ -123,6 +163,8 @@ Simultaneous_music_iterator::process (Moment until)
       for (SCM p = children_list_; scm_is_pair (p); p = scm_cdr (p))
         unsmob<Music_iterator> (scm_car (p))->quit ();
       children_list_ = SCM_EOL;
+      queue_ = std::priority_queue<Child, vector<Child>, Child_later> ();
+      always_.clear ();
     }
 }
 
@@ -132,11 +174,10 @@ Simultaneous_music_iterator::pending_moment () const
   Moment next;
   next.set_infinite (1);
 
-  for (SCM s = children_list_; scm_is_pair (s); s = scm_cdr (s))
-    {
-      Music_iterator *it = unsmob<Music_iterator> (scm_car (s));
-      next = min (next, it->pending_moment ());
-    }
+  if (!queue_.empty ())
+    next = queue_.top ().when_;
+  for (vsize i = 0; i < always_.size (); i++)
+    next = min (next, always_[i].iter_->pending_moment ());
 
   return next;
 }
@@ -156,12 +197,9 @@ Simultaneous_music_iterator::ok () const
 bool
 Simultaneous_music_iterator::run_always () const
 {
-  for (SCM s = children_list_; scm_is_pair (s); s = scm_cdr (s))
-    {
-      Music_iterator *it = unsmob<Music_iterator> (scm_car (s));
-      if (it->run_always ())
-        return true;
-    }
+  for (vsize i = 0; i < always_.size (); i++)
+    if (always_[i].iter_->run_always ())
+      return true;
   return false;
 }
 
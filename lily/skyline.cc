@@ -524,6 +524,36 @@ Skyline::merge (Skyline const &other)
   normalize ();
 }
 
+/*
+  Merge OTHER raised by RAISE into this skyline.  This is the same as
+  merging a raised copy of OTHER, but it only copies OTHER's buildings
+  once, which matters when a skyline is grown one piece at a time.
+*/
+void
+Skyline::merge (Skyline const &other, Real raise)
+{
+  assert (sky_ == other.sky_);
+
+  if (other.is_empty ())
+    return;
+
+  list<Building> other_bld (other.buildings_);
+  list<Building>::iterator end = other_bld.end ();
+  for (list<Building>::iterator i = other_bld.begin (); i != end; i++)
+    i->y_intercept_ += sky_ * raise;
+
+  if (is_empty ())
+    {
+      buildings_.swap (other_bld);
+      return;
+    }
+
+  list<Building> my_bld;
+  my_bld.splice (my_bld.begin (), buildings_);
+  internal_merge_skyline (&other_bld, &my_bld, &buildings_);
+  normalize ();
+}
+
 void
 Skyline::insert (Box const &b, Axis a)
 {
@@ -704,6 +734,58 @@ Skyline::height (Real airplane) const
   return 0;
 }
 
+Skyline_index::Skyline_index ()
+{
+  sky_ = UP;
+}
+
+Skyline_index::Skyline_index (Skyline const &s)
+{
+  sky_ = s.sky_;
+  buildings_.assign (s.buildings_.begin (), s.buildings_.end ());
+}
+
+static bool
+building_ends_before (Building const &b, Real x)
+{
+  return b.end_ < x;
+}
+
+/*
+  Return a skyline that agrees with the indexed one over the closed
+  interval IV and is empty elsewhere, except for the buildings that
+  cross the ends of IV.  Its distance to a skyline that is empty
+  outside IV is the same as that of the whole skyline.
+*/
+Skyline
+Skyline_index::section (Interval iv) const
+{
+  Skyline ret (sky_);
+  if (iv.is_empty ())
+    return ret;
+
+  vector<Building>::const_iterator first
+    = lower_bound (buildings_.begin (), buildings_.end (), iv[LEFT],
+                   building_ends_before);
+  vector<Building>::const_iterator last = first;
+  while (last != buildings_.end () && last->start_ <= iv[RIGHT])
+    last++;
+  if (first == last)
+    return ret;
+
+  ret.buildings_.clear ();
+  if (first->start_ > -infinity_f)
+    ret.buildings_.push_back (Building (-infinity_f, -infinity_f,
+                                        -infinity_f, first->start_));
+  ret.buildings_.insert (ret.buildings_.end (), first, last);
+  Real end = (last - 1)->end_;
+  if (end < infinity_f)
+    ret.buildings_.push_back (Building (end, -infinity_f,
+                                        -infinity_f, infinity_f));
+  ret.normalize ();
+  return ret;
+}
+
 Real
 Skyline::max_height () const
 {
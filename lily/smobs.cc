@@ -18,7 +18,14 @@
 */
 
 #include "smobs.hh"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "gc-pacing.hh"
+#include "international.hh"
 #include "listener.hh"
+#include "program-option.hh"
 
 Listener
 Smob_core::get_listener (SCM callback)
@@ -102,3 +109,97 @@ Scm_init::init ()
   for (Scm_init const *p = list_; p; p = p->next_)
     p->fun_ ();
 }
+
+Smob_count *Smob_count::list_ = 0;
+
+void
+Smob_count::enroll (const char *name, size_t size)
+{
+  name_ = name;
+  size_ = size;
+  next_ = list_;
+  list_ = this;
+}
+
+static bool
+more_memory (Smob_count const *a, Smob_count const *b)
+{
+  return a->live () * a->size_ > b->live () * b->size_;
+}
+
+/*
+  Print the allocation counts of all smob types that have been used,
+  largest live memory first.  A garbage collection is done first, so
+  that the live counts do not include unreachable objects.
+*/
+static void
+print_memory_report (const string &phase)
+{
+  scm_gc ();
+
+  vector<Smob_count *> counts;
+  for (Smob_count *c = Smob_count::list_; c; c = c->next_)
+    if (c->allocated_)
+      counts.push_back (c);
+  sort (counts.begin (), counts.end (), more_memory);
+
+  string report = _f ("Memory report (%s):", phase.c_str ()) + "\n";
+  char line[200];
+  snprintf (line, sizeof (line), "  %-24s %12s %12s %12s %14s\n",
+            "type", "allocated", "freed", "live", "live bytes");
+  report += line;
+  for (vsize i = 0; i < counts.size (); i++)
+    {
+      Smob_count const *c = counts[i];
+      snprintf (line, sizeof (line), "  %-24s %12lu %12lu %12lu %14lu\n",
+                c->name_, c->allocated_, c->freed_, c->live (),
+                (unsigned long) (c->live () * c->size_));
+      report += line;
+    }
+
+  size_t cells = gc_statistic ("cells-allocated");
+  size_t heap = gc_statistic ("heap-size");
+  if (cells)
+    report += _f ("  Scheme heap: %lu cells in use, %lu bytes",
+                  (unsigned long) cells, (unsigned long) heap) + "\n";
+  else
+    report += _f ("  Scheme heap: %lu bytes", (unsigned long) heap) + "\n";
+
+  message (report);
+}
+
+void
+report_memory (const string &phase)
+{
+  if (get_program_option ("memory-report"))
+    print_memory_report (phase);
+}
+
+LY_DEFINE (ly_smob_counts, "ly:smob-counts",
+           0, 0, 0, (),
+           "Return a list with an entry"
+           " @code{(@var{type} @var{allocated} @var{freed} @var{size})}"
+           " for every smob type that has been used.  @var{size} is the"
+           " approximate size of one object in bytes.")
+{
+  SCM result = SCM_EOL;
+  for (Smob_count *c = Smob_count::list_; c; c = c->next_)
+    if (c->allocated_)
+      result = scm_cons (scm_list_4 (scm_from_locale_string (c->name_),
+                                     scm_from_ulong (c->allocated_),
+                                     scm_from_ulong (c->freed_),
+                                     scm_from_size_t (c->size_)),
+                         result);
+  return result;
+}
+
+LY_DEFINE (ly_memory_report, "ly:memory-report",
+           1, 0, 0, (SCM phase),
+           "Collect garbage and print the number of live objects and"
+           " their approximate memory use for every smob type."
+           "  @var{phase} is a string that is printed in the header.")
+{
+  LY_ASSERT_TYPE (scm_is_string, phase, 1);
+  print_memory_report (ly_scm2string (phase));
+  return SCM_UNSPECIFIED;
+}
@@ -227,7 +227,6 @@ Spanner::set_bound (Direction d, Grob *s)
 Preinit_Spanner::Preinit_Spanner ()
 {
   spanned_drul_.set (0, 0);
-  pure_property_cache_ = SCM_UNDEFINED;
 }
 
 Spanner::Spanner (SCM s)
@@ -337,7 +336,7 @@ Spanner::is_broken () const
 void
 Spanner::derived_mark () const
 {
-  scm_gc_mark (pure_property_cache_);
+  pure_property_cache_.mark ();
 
   for (LEFT_and_RIGHT (d))
     if (spanned_drul_[d])
@@ -536,21 +535,13 @@ Spanner::get_cached_pure_property (SCM sym, int start, int end)
   // The pure property cache is indexed by (name start . end), where name is
   // a symbol, and start and end are numbers referring to the starting and
   // ending column ranks of the current line.
-  if (scm_is_false (scm_hash_table_p (pure_property_cache_)))
-    return SCM_UNDEFINED;
-
-  SCM key = scm_cons (sym, scm_cons (scm_from_int (start), scm_from_int (end)));
-  return scm_hash_ref (pure_property_cache_, key, SCM_UNDEFINED);
+  return pure_property_cache_.get (sym, start, end);
 }
 
 void
 Spanner::cache_pure_property (SCM sym, int start, int end, SCM val)
 {
-  if (scm_is_false (scm_hash_table_p (pure_property_cache_)))
-    pure_property_cache_ = scm_c_make_hash_table (17);
-
-  SCM key = scm_cons (sym, scm_cons (scm_from_int (start), scm_from_int (end)));
-  scm_hash_set_x (pure_property_cache_, key, val);
+  pure_property_cache_.set (sym, start, end, val);
 }
 
 ADD_INTERFACE (Spanner,
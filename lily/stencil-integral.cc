@@ -47,6 +47,7 @@ when this transforms a point (x,y), the point is written as matrix:
 #include "open-type-font.hh"
 #include "pango-font.hh"
 #include "pointer-group-interface.hh"
+#include "protected-scm.hh"
 #include "lily-guile.hh"
 #include "real.hh"
 #include "rest.hh"
@@ -1023,6 +1024,13 @@ Grob::simple_horizontal_skylines_from_extents (SCM smob)
   return maybe_pure_internal_simple_skylines_from_extents (me, Y_AXIS, false, 0, 0, false, to_boolean (me->get_property ("cross-staff")));
 }
 
+/*
+  Glyph stencils are shared between grobs (see
+  Font_metric::find_by_name), so their skylines are kept with the
+  expression, one for every padding, axis and extent asked for.
+*/
+static Protected_scm glyph_skylines;
+
 SCM
 Stencil::skylines_from_stencil (SCM sten, Real pad, Axis a)
 {
@@ -1030,6 +1038,23 @@ Stencil::skylines_from_stencil (SCM sten, Real pad, Axis a)
   if (!s)
     return Skyline_pair ().smobbed_copy ();
 
+  SCM expr = s->expr ();
+  bool glyph = scm_is_pair (expr)
+               && scm_is_eq (scm_car (expr), ly_symbol2scm ("named-glyph"));
+  SCM key = SCM_EOL;
+  if (glyph)
+    {
+      if (!glyph_skylines.is_bound ())
+        glyph_skylines = scm_make_weak_key_hash_table (scm_from_int (59));
+
+      key = scm_list_4 (scm_from_double (pad), scm_from_int (a),
+                        ly_interval2scm (s->extent (X_AXIS)),
+                        ly_interval2scm (s->extent (Y_AXIS)));
+      SCM hit = scm_assoc (key, scm_hashq_ref (glyph_skylines, expr, SCM_EOL));
+      if (scm_is_pair (hit))
+        return unsmob<Skyline_pair> (scm_cdr (hit))->smobbed_copy ();
+    }
+
   vector<Transform_matrix_and_expression> data
     = stencil_traverser (make_transform_matrix (1.0, 0.0, 0.0, 1.0, 0.0, 0.0),
                          s->expr ());
@@ -1048,6 +1073,10 @@ Stencil::skylines_from_stencil (SCM sten, Real pad, Axis a)
   for (DOWN_and_UP (d))
     out[d] = out[d].padded (pad);
 
+  if (glyph)
+    scm_hashq_set_x (glyph_skylines, expr,
+                     scm_acons (key, out.smobbed_copy (),
+                                scm_hashq_ref (glyph_skylines, expr, SCM_EOL)));
   return out.smobbed_copy ();
 }
 
@@ -0,0 +1,491 @@
+/*
+  This file is part of LilyPond, the GNU music typesetter.
+
+  Copyright (C) 2026 The LilyPond development team
+
+  LilyPond is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  LilyPond is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+  Draw stencil expressions on a Raster_canvas.  This replaces the
+  PostScript and Ghostscript round trip for PNG output.
+*/
+
+#include <cmath>
+
+#include "dimensions.hh"
+#include "international.hh"
+#include "modified-font-metric.hh"
+#include "open-type-font.hh"
+#include "output-def.hh"
+#include "pango-font.hh"
+#include "raster-canvas.hh"
+#include "stencil.hh"
+#include "warn.hh"
+
+struct Raster_state
+{
+  Raster_canvas *canvas_;
+  Real output_scale_;
+  bool warned_embedded_ps_;
+};
+
+static SCM
+unquote (SCM x)
+{
+  if (scm_is_pair (x) && scm_is_eq (scm_car (x), ly_symbol2scm ("quote")))
+    return scm_cadr (x);
+  return x;
+}
+
+static Real
+arg_double (SCM args, int i)
+{
+  return robust_scm2double (unquote (scm_list_ref (args, scm_from_int (i))),
+                            0.0);
+}
+
+static bool
+arg_bool (SCM args, int i)
+{
+  return scm_is_true (unquote (scm_list_ref (args, scm_from_int (i))));
+}
+
+static PangoMatrix
+translation (Offset o)
+{
+  PangoMatrix m = PANGO_MATRIX_INIT;
+  m.x0 = o[X_AXIS];
+  m.y0 = o[Y_AXIS];
+  return m;
+}
+
+static int
+line_cap (SCM sym)
+{
+  if (scm_is_eq (sym, ly_symbol2scm ("butt")))
+    return Raster_canvas::BUTT_CAP;
+  if (scm_is_eq (sym, ly_symbol2scm ("square")))
+    return Raster_canvas::SQUARE_CAP;
+  return Raster_canvas::ROUND_CAP;
+}
+
+static int
+line_join (SCM sym)
+{
+  if (scm_is_eq (sym, ly_symbol2scm ("miter")))
+    return Raster_canvas::MITER_JOIN;
+  if (scm_is_eq (sym, ly_symbol2scm ("bevel")))
+    return Raster_canvas::BEVEL_JOIN;
+  return Raster_canvas::ROUND_JOIN;
+}
+
+static void
+paint (Raster_canvas *canvas, bool fill, Real thickness)
+{
+  if (fill)
+    canvas->fill_and_stroke (thickness, Raster_canvas::ROUND_CAP,
+                             Raster_canvas::ROUND_JOIN);
+  else
+    canvas->stroke (thickness, Raster_canvas::ROUND_CAP,
+                    Raster_canvas::ROUND_JOIN);
+}
+
+/*
+  Elliptic arc with radii RX and RY, from parametric angle START to
+  END (radians), as Bezier curves.
+*/
+static void
+add_arc (Raster_canvas *canvas, Real rx, Real ry, Real start, Real end,
+         bool move)
+{
+  int n = max (int (ceil ((end - start) / (M_PI / 2) - 1e-9)), 1);
+  Real step = (end - start) / n;
+  Real k = 4.0 / 3 * tan (step / 4);
+
+  if (move)
+    canvas->move_to (Offset (rx * cos (start), ry * sin (start)));
+  for (int i = 0; i < n; i++)
+    {
+      Real a = start + i * step;
+      Real b = a + step;
+      canvas->curve_to (Offset (rx * (cos (a) - k * sin (a)),
+                                ry * (sin (a) + k * cos (a))),
+                        Offset (rx * (cos (b) + k * sin (b)),
+                                ry * (sin (b) - k * cos (b))),
+                        Offset (rx * cos (b), ry * sin (b)));
+    }
+}
+
+static void
+draw_path (Raster_canvas *canvas, SCM args)
+{
+  Real thickness = arg_double (args, 0);
+  SCM exps = unquote (scm_cadr (args));
+  SCM rest = scm_cddr (args);
+  SCM cap = scm_is_pair (rest) ? unquote (scm_car (rest)) : SCM_EOL;
+  rest = scm_is_pair (rest) ? scm_cdr (rest) : rest;
+  SCM join = scm_is_pair (rest) ? unquote (scm_car (rest)) : SCM_EOL;
+  rest = scm_is_pair (rest) ? scm_cdr (rest) : rest;
+  bool fill = scm_is_pair (rest) && scm_is_true (unquote (scm_car (rest)));
+
+  Offset current;
+  vector<Real> nums;
+  while (scm_is_pair (exps))
+    {
+      SCM head = scm_car (exps);
+      exps = scm_cdr (exps);
+
+      int arity = 0;
+      if (scm_is_eq (head, ly_symbol2scm ("moveto"))
+          || scm_is_eq (head, ly_symbol2scm ("rmoveto"))
+          || scm_is_eq (head, ly_symbol2scm ("lineto"))
+          || scm_is_eq (head, ly_symbol2scm ("rlineto")))
+        arity = 2;
+      else if (scm_is_eq (head, ly_symbol2scm ("curveto"))
+               || scm_is_eq (head, ly_symbol2scm ("rcurveto")))
+        arity = 6;
+      else if (!scm_is_eq (head, ly_symbol2scm ("closepath")))
+        {
+          warning (_f ("unknown path command: %s",
+                       ly_scm2string (scm_symbol_to_string (head))));
+          continue;
+        }
+
+      nums.clear ();
+      for (int i = 0; i < arity && scm_is_pair (exps); i++)
+        {
+          nums.push_back (robust_scm2double (scm_car (exps), 0.0));
+          exps = scm_cdr (exps);
+        }
+      if (int (nums.size ()) < arity)
+        break;
+
+      bool relative = scm_is_eq (head, ly_symbol2scm ("rmoveto"))
+                      || scm_is_eq (head, ly_symbol2scm ("rlineto"))
+                      || scm_is_eq (head, ly_symbol2scm ("rcurveto"));
+      vector<Offset> pts;
+      for (int i = 0; i < arity; i += 2)
+        pts.push_back (Offset (nums[i], nums[i + 1])
+                       + (relative ? current : Offset (0, 0)));
+
+      if (arity == 0)
+        canvas->close_path ();
+      else if (scm_is_eq (head, ly_symbol2scm ("moveto"))
+               || scm_is_eq (head, ly_symbol2scm ("rmoveto")))
+        canvas->move_to (pts[0]);
+      else if (arity == 2)
+        canvas->line_to (pts[0]);
+      else
+        canvas->curve_to (pts[0], pts[1], pts[2]);
+
+      if (arity)
+        current = pts.back ();
+    }
+
+  int c = line_cap (cap);
+  int j = line_join (join);
+  if (!fill)
+    canvas->stroke (thickness, c, j);
+  else if (thickness > 0)
+    canvas->fill_and_stroke (thickness, c, j);
+  else
+    canvas->fill ();
+}
+
+static void
+draw_glyph_string (Raster_state *state, SCM args)
+{
+  Pango_font *pf = dynamic_cast<Pango_font *> (unsmob<Font_metric> (scm_car (args)));
+  if (!pf)
+    return;
+
+  SCM ps_name = unquote (scm_cadr (args));
+  Real size = arg_double (args, 2) / state->output_scale_;
+  Real x = 0.0;
+  for (SCM s = unquote (scm_list_ref (args, scm_from_int (4)));
+       scm_is_pair (s); s = scm_cdr (s))
+    {
+      SCM glyph = scm_car (s);
+      Real w = robust_scm2double (scm_car (glyph), 0.0);
+      Offset o (x + robust_scm2double (scm_caddr (glyph), 0.0),
+                robust_scm2double (scm_cadddr (glyph), 0.0));
+      pf->fill_glyph (state->canvas_, ps_name,
+                      scm_list_ref (glyph, scm_from_int (4)), size, o);
+      x += w;
+    }
+}
+
+static void
+draw_named_glyph (Raster_canvas *canvas, SCM args)
+{
+  Modified_font_metric *mfm
+    = dynamic_cast<Modified_font_metric *> (unsmob<Font_metric> (scm_car (args)));
+  Open_type_font *otf
+    = mfm ? dynamic_cast<Open_type_font *> (mfm->original_font ()) : 0;
+  if (!otf)
+    return;
+
+  size_t idx = otf->name_to_index (ly_scm2string (scm_cadr (args)));
+  if (idx != (size_t) - 1)
+    otf->fill_glyph (canvas, idx,
+                     mfm->get_magnification () * otf->design_size (),
+                     Offset (0, 0));
+}
+
+static void
+draw_primitive (Raster_state *state, SCM expr)
+{
+  if (!scm_is_pair (expr))
+    return;
+
+  Raster_canvas *canvas = state->canvas_;
+  SCM head = scm_car (expr);
+  SCM args = scm_cdr (expr);
+
+  if (scm_is_eq (head, ly_symbol2scm ("draw-line")))
+    {
+      canvas->move_to (Offset (arg_double (args, 1), arg_double (args, 2)));
+      canvas->line_to (Offset (arg_double (args, 3), arg_double (args, 4)));
+      canvas->stroke (arg_double (args, 0), Raster_canvas::ROUND_CAP,
+                      Raster_canvas::ROUND_JOIN);
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("dashed-line")))
+    {
+      Real thick = arg_double (args, 0);
+      Real on = arg_double (args, 1);
+      Real off = arg_double (args, 2);
+      Offset end (arg_double (args, 3), arg_double (args, 4));
+      Real phase = arg_double (args, 5);
+      Real len = end.length ();
+      Offset dir = end.direction ();
+      Real period = on + off;
+
+      if (period <= 0 || len <= 0)
+        {
+          canvas->move_to (Offset (0, 0));
+          canvas->line_to (end);
+        }
+      else
+        {
+          Real start = -fmod (phase, period);
+          if (start > 0)
+            start -= period;
+          for (Real s = start; s < len; s += period)
+            if (s + on >= 0)
+              {
+                canvas->move_to (dir * max (s, 0.0));
+                canvas->line_to (dir * min (s + on, len));
+              }
+        }
+      canvas->stroke (thick, Raster_canvas::ROUND_CAP,
+                      Raster_canvas::ROUND_JOIN);
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("round-filled-box")))
+    {
+      Real blot = arg_double (args, 4);
+      Real half = blot / 2;
+      Real x0 = -arg_double (args, 0) + half;
+      Real x1 = arg_double (args, 1) - half;
+      Real y0 = -arg_double (args, 2) + half;
+      Real y1 = arg_double (args, 3) - half;
+      if (blot <= 0)
+        {
+          canvas->move_to (Offset (x0, y0));
+          canvas->line_to (Offset (x1, y0));
+          canvas->line_to (Offset (x1, y1));
+          canvas->line_to (Offset (x0, y1));
+          canvas->close_path ();
+          canvas->fill ();
+        }
+      else
+        {
+          x1 = max (x0, x1);
+          y1 = max (y0, y1);
+          canvas->move_to (Offset (x0, y0));
+          canvas->line_to (Offset (x1, y0));
+          canvas->line_to (Offset (x1, y1));
+          canvas->line_to (Offset (x0, y1));
+          canvas->close_path ();
+          canvas->fill_and_stroke (blot, Raster_canvas::ROUND_CAP,
+                                   Raster_canvas::ROUND_JOIN);
+        }
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("polygon")))
+    {
+      SCM points = unquote (scm_car (args));
+      bool first = true;
+      for (SCM s = points; scm_is_pair (s) && scm_is_pair (scm_cdr (s));
+           s = scm_cddr (s))
+        {
+          Offset p (robust_scm2double (scm_car (s), 0.0),
+                    robust_scm2double (scm_cadr (s), 0.0));
+          if (first)
+            canvas->move_to (p);
+          else
+            canvas->line_to (p);
+          first = false;
+        }
+      canvas->close_path ();
+      paint (canvas, arg_bool (args, 2), arg_double (args, 1));
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("circle")))
+    {
+      Real r = arg_double (args, 0);
+      add_arc (canvas, r, r, 0, 2 * M_PI, true);
+      canvas->close_path ();
+      paint (canvas, arg_bool (args, 2), arg_double (args, 1));
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("ellipse")))
+    {
+      add_arc (canvas, arg_double (args, 0), arg_double (args, 1),
+               0, 2 * M_PI, true);
+      canvas->close_path ();
+      paint (canvas, arg_bool (args, 3), arg_double (args, 2));
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("partial-ellipse")))
+    {
+      Real rx = arg_double (args, 0);
+      Real ry = arg_double (args, 1);
+
+      /* Turn polar angles into parametric angles of the ellipse.  */
+      Real angles[2];
+      for (int i = 0; i < 2; i++)
+        {
+          Real rad = arg_double (args, 2 + i) * M_PI / 180;
+          angles[i] = atan2 (rx * sin (rad), ry * cos (rad));
+          if (angles[i] < 0)
+            angles[i] += 2 * M_PI;
+        }
+      if (angles[1] <= angles[0])
+        angles[1] += 2 * M_PI;
+
+      add_arc (canvas, rx, ry, angles[0], angles[1], true);
+      if (arg_bool (args, 5))
+        canvas->close_path ();
+      paint (canvas, arg_bool (args, 6), arg_double (args, 4));
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("path")))
+    draw_path (canvas, args);
+  else if (scm_is_eq (head, ly_symbol2scm ("named-glyph")))
+    draw_named_glyph (canvas, args);
+  else if (scm_is_eq (head, ly_symbol2scm ("glyph-string")))
+    draw_glyph_string (state, args);
+  else if (scm_is_eq (head, ly_symbol2scm ("embedded-ps")))
+    {
+      if (!state->warned_embedded_ps_)
+        warning (_ ("built-in rasterizer ignores embedded PostScript"));
+      state->warned_embedded_ps_ = true;
+    }
+}
+
+static SCM
+rasterize_expression (void *arg, SCM expr)
+{
+  Raster_state *state = (Raster_state *) arg;
+  Raster_canvas *canvas = state->canvas_;
+  SCM head = scm_car (expr);
+  SCM args = scm_cdr (expr);
+
+  if (scm_is_eq (head, ly_symbol2scm ("placebox")))
+    {
+      canvas->push_transform (translation (Offset (arg_double (args, 0),
+                                                   arg_double (args, 1))));
+      draw_primitive (state, scm_caddr (args));
+      canvas->pop_transform ();
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("setcolor")))
+    canvas->push_color (arg_double (args, 0), arg_double (args, 1),
+                        arg_double (args, 2));
+  else if (scm_is_eq (head, ly_symbol2scm ("resetcolor")))
+    canvas->pop_color ();
+  else if (scm_is_eq (head, ly_symbol2scm ("setrotation")))
+    {
+      /* Rotate counterclockwise around the given point.  */
+      Real rad = arg_double (args, 0) * M_PI / 180;
+      Real x = arg_double (args, 1);
+      Real y = arg_double (args, 2);
+      Real c = cos (rad);
+      Real s = sin (rad);
+      PangoMatrix m = PANGO_MATRIX_INIT;
+      m.xx = c;
+      m.xy = -s;
+      m.yx = s;
+      m.yy = c;
+      m.x0 = x - c * x + s * y;
+      m.y0 = y - s * x - c * y;
+      canvas->push_transform (m);
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("setscale")))
+    {
+      PangoMatrix m = PANGO_MATRIX_INIT;
+      m.xx = arg_double (args, 0);
+      m.yy = arg_double (args, 1);
+      canvas->push_transform (m);
+    }
+  else if (scm_is_eq (head, ly_symbol2scm ("resetrotation"))
+           || scm_is_eq (head, ly_symbol2scm ("resetscale")))
+    canvas->pop_transform ();
+  else if (scm_is_eq (head, ly_symbol2scm ("grob-cause")))
+    return SCM_BOOL_F;
+
+  return SCM_BOOL_T;
+}
+
+LY_DEFINE (ly_stencil_2_png, "ly:stencil->png",
+           6, 0, 0, (SCM paper, SCM stencil, SCM x_ext, SCM y_ext,
+                     SCM resolution, SCM file_name),
+           "Render the part of @var{stencil} inside @var{x-ext} and"
+           " @var{y-ext} to the PNG file @var{file-name}, with"
+           " @var{resolution} pixels per inch.  The output scale is"
+           " taken from @var{paper}.  Return @code{#t} on success.")
+{
+  LY_ASSERT_SMOB (Output_def, paper, 1);
+  LY_ASSERT_SMOB (Stencil, stencil, 2);
+  LY_ASSERT_TYPE (is_number_pair, x_ext, 3);
+  LY_ASSERT_TYPE (is_number_pair, y_ext, 4);
+  LY_ASSERT_TYPE (scm_is_number, resolution, 5);
+  LY_ASSERT_TYPE (scm_is_string, file_name, 6);
+
+  Output_def *odef = unsmob<Output_def> (paper);
+  Stencil *s = unsmob<Stencil> (stencil);
+  Interval x = ly_scm2interval (x_ext);
+  Interval y = ly_scm2interval (y_ext);
+
+  Real output_scale = robust_scm2double (odef->c_variable ("output-scale"),
+                                         1.0);
+  Real ppu = output_scale * scm_to_double (resolution) / inch_constant;
+  Real width = ceil (x.length () * ppu);
+  Real height = ceil (y.length () * ppu);
+  if (!(width >= 1 && height >= 1 && width * height <= 2.5e8))
+    {
+      warning (_f ("cannot rasterize image of %.0f x %.0f pixels",
+                   width, height));
+      return SCM_BOOL_F;
+    }
+
+  PangoMatrix device = PANGO_MATRIX_INIT;
+  device.xx = ppu;
+  device.yy = -ppu;
+  device.x0 = -x[LEFT] * ppu;
+  device.y0 = y[RIGHT] * ppu;
+
+  Raster_canvas canvas (int (width), int (height), device);
+  Raster_state state = {&canvas, output_scale, false};
+  interpret_stencil_expression (s->expr (), rasterize_expression,
+                                (void *) &state, Offset (0, 0));
+  scm_remember_upto_here_1 (stencil);
+
+  return scm_from_bool (canvas.write_png (ly_scm2string (file_name)));
+}
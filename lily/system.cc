@@ -22,7 +22,10 @@
 #include "align-interface.hh"
 #include "all-font-metrics.hh"
 #include "axis-group-interface.hh"
+#include "beam.hh"
 #include "break-align-interface.hh"
+#include "break-substitution.hh"
+#include "cpu-timer.hh"
 #include "grob-array.hh"
 #include "hara-kiri-group-spanner.hh"
 #include "international.hh"
@@ -34,6 +37,7 @@
 #include "paper-score.hh"
 #include "paper-system.hh"
 #include "pointer-group-interface.hh"
+#include "program-option.hh"
 #include "skyline-pair.hh"
 #include "staff-symbol-referencer.hh"
 #include "system-start-delimiter.hh"
@@ -169,10 +173,20 @@ System::do_break_substitution_and_fixup_refpoints ()
   */
   fixup_refpoints (all_elements_->array ());
 
-  for (vsize i = 0; i < all_elements_->size (); i++)
-    all_elements_->grob (i)->handle_broken_dependencies ();
+  {
+    Cpu_timer timer;
+    Break_substitution_table table (this);
+
+    for (vsize i = 0; i < all_elements_->size (); i++)
+      all_elements_->grob (i)->handle_broken_dependencies ();
 
-  handle_broken_dependencies ();
+    handle_broken_dependencies ();
+
+    debug_output (_f ("Break substitution: %d grobs, %d lookups, %d resolved,"
+                      " %.2f seconds",
+                      int (table.size ()), int (table.lookup_count_),
+                      int (table.resolve_count_), timer.read ()));
+  }
 
   /* Because the get_property (all-elements) contains items in 3
      versions, handle_broken_dependencies () will leave duplicated
@@ -531,6 +545,10 @@ System::pre_processing ()
 void
 System::post_processing ()
 {
+  int jobs = robust_scm2int (ly_get_option (ly_symbol2scm ("quanting-job-count")), 1);
+  if (jobs > 1)
+    Beam::quant_in_advance (all_elements_->array (), jobs);
+
   Interval iv (extent (this, Y_AXIS));
   if (iv.is_empty ())
     programming_error ("system with empty extent");
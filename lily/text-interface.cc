@@ -26,6 +26,7 @@
 #include "font-interface.hh"
 #include "grob.hh"
 #include "main.hh"
+#include "markup-cache.hh"
 #include "misc.hh"
 #include "modified-font-metric.hh"
 #include "output-def.hh"
@@ -101,21 +102,12 @@ static size_t markup_depth = 0;
 void markup_up_depth (void *) { ++markup_depth; }
 void markup_down_depth (void *) { --markup_depth; }
 
-MAKE_SCHEME_CALLBACK_WITH_OPTARGS (Text_interface, interpret_markup, 3, 0,
-                                   "Convert a text markup into a stencil."
-                                   "  Takes three arguments, @var{layout}, @var{props}, and @var{markup}.\n"
-                                   "\n"
-                                   "@var{layout} is a @code{\\layout} block; it may be obtained from a grob with"
-                                   " @code{ly:grob-layout}.  @var{props} is an alist chain, i.e. a list of"
-                                   "  alists.  This is typically obtained with"
-                                   " @code{(ly:grob-alist-chain grob (ly:output-def-lookup layout 'text-font-defaults))}."
-                                   "  @var{markup} is the markup text to be processed.");
-SCM
-Text_interface::interpret_markup (SCM layout_smob, SCM props, SCM markup)
+static SCM
+interpret_uncached (SCM layout_smob, SCM props, SCM markup)
 {
   if (scm_is_string (markup))
-    return interpret_string (layout_smob, props, markup);
-  else if (is_markup (markup))
+    return Text_interface::interpret_string (layout_smob, props, markup);
+  else if (Text_interface::is_markup (markup))
     {
       SCM func = scm_car (markup);
       SCM args = scm_cdr (markup);
@@ -157,6 +149,33 @@ Text_interface::interpret_markup (SCM layout_smob, SCM props, SCM markup)
     }
 }
 
+MAKE_SCHEME_CALLBACK_WITH_OPTARGS (Text_interface, interpret_markup, 3, 0,
+                                   "Convert a text markup into a stencil."
+                                   "  Takes three arguments, @var{layout}, @var{props}, and @var{markup}.\n"
+                                   "\n"
+                                   "@var{layout} is a @code{\\layout} block; it may be obtained from a grob with"
+                                   " @code{ly:grob-layout}.  @var{props} is an alist chain, i.e. a list of"
+                                   "  alists.  This is typically obtained with"
+                                   " @code{(ly:grob-alist-chain grob (ly:output-def-lookup layout 'text-font-defaults))}."
+                                   "  @var{markup} is the markup text to be processed.");
+SCM
+Text_interface::interpret_markup (SCM layout_smob, SCM props, SCM markup)
+{
+  if (!Markup_cache::is_enabled ())
+    return interpret_uncached (layout_smob, props, markup);
+
+  SCM stencil = Markup_cache::lookup (layout_smob, props, markup);
+  if (!SCM_UNBNDP (stencil))
+    return stencil;
+
+  scm_dynwind_begin ((scm_t_dynwind_flags)0);
+  Markup_cache::start_recording (props);
+  stencil = interpret_uncached (layout_smob, props, markup);
+  Markup_cache::store (layout_smob, markup, stencil);
+  scm_dynwind_end ();
+  return stencil;
+}
+
 MAKE_SCHEME_CALLBACK (Text_interface, print, 1);
 SCM
 Text_interface::print (SCM grob)
@@ -77,6 +77,7 @@ Tie_details::from_grob (Grob *me)
   single_tie_region_size_ = get_int_detail ("single-tie-region-size", 3);
   skyline_padding_ = get_real_detail ("skyline-padding", 0.05);
   multi_tie_region_size_ = get_int_detail ("multi-tie-region-size", 1);
+  variation_search_depth_ = get_int_detail ("variation-search-depth", 1);
 }
 
 Tie_details::Tie_details ()
@@ -84,5 +85,6 @@ Tie_details::Tie_details ()
   staff_space_ = 1.0;
   height_limit_ = 1.0;
   ratio_ = .333;
+  variation_search_depth_ = 1;
 }
 
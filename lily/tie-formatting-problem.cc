@@ -25,6 +25,7 @@
 #include "paper-column.hh"
 #include "bezier.hh"
 #include "directional-element-interface.hh"
+#include "international.hh"
 #include "libc-extension.hh"
 #include "misc.hh"
 #include "note-head.hh"
@@ -38,6 +39,7 @@
 #include "warn.hh"
 #include "pointer-group-interface.hh"
 #include "output-def.hh"
+#include "program-option.hh"
 
 void
 Tie_formatting_problem::print_ties_configuration (Ties_configuration const *ties)
@@ -812,52 +814,246 @@ Tie_formatting_problem::score_ties_configuration (Ties_configuration *ties) cons
       ties->add_tie_score (ties->at (i).score (), i, "conf");
     }
 
-  Real last_edge = 0.0;
-  Real last_center = 0.0;
-  for (vsize i = 0; i < ties->size (); i++)
+  for (vsize i = 1; i < ties->size (); i++)
+    score_adjacent_ties (ties->at (i - 1), ties->at (i), ties);
+
+  if (ties->size () > 1)
+    score_outer_ties (ties->at (0), ties->back (), ties);
+}
+
+/**
+   Score the interaction of the vertically adjacent ties LOWER and
+   UPPER.  TIES_CONF is optional; if given, the penalties are added to
+   its score card, otherwise they are returned.
+ */
+Real
+Tie_formatting_problem::score_adjacent_ties (Tie_configuration const &lower,
+                                             Tie_configuration const &upper,
+                                             Ties_configuration *ties_conf) const
+{
+  Bezier lower_b (lower.get_transformed_bezier (details_));
+  Bezier upper_b (upper.get_transformed_bezier (details_));
+
+  Real last_center = lower_b.curve_point (0.5)[Y_AXIS];
+  Real last_edge = lower_b.curve_point (0.0)[Y_AXIS];
+  Real center = upper_b.curve_point (0.5)[Y_AXIS];
+  Real edge = upper_b.curve_point (0.0)[Y_AXIS];
+
+  Real penalty = 0.0;
+  Real p = (edge <= last_edge) ? details_.tie_column_monotonicity_penalty_ : 0.0;
+  if (ties_conf)
+    ties_conf->add_score (p, "monoton edge");
+  else
+    penalty += p;
+
+  p = (center <= last_center) ? details_.tie_column_monotonicity_penalty_ : 0.0;
+  if (ties_conf)
+    ties_conf->add_score (p, "monoton cent");
+  else
+    penalty += p;
+
+  p = details_.tie_tie_collision_penalty_
+      * peak_around (0.1 * details_.tie_tie_collision_distance_,
+                     details_.tie_tie_collision_distance_,
+                     fabs (center - last_center));
+  if (ties_conf)
+    ties_conf->add_score (p, "tietie center");
+  else
+    penalty += p;
+
+  p = details_.tie_tie_collision_penalty_
+      * peak_around (0.1 * details_.tie_tie_collision_distance_,
+                     details_.tie_tie_collision_distance_,
+                     fabs (edge - last_edge));
+  if (ties_conf)
+    ties_conf->add_score (p, "tietie edge");
+  else
+    penalty += p;
+
+  return penalty;
+}
+
+/**
+   Score the symmetry of the outermost ties FIRST and LAST of a chord.
+   TIES_CONF is optional, as for score_adjacent_ties ().
+ */
+Real
+Tie_formatting_problem::score_outer_ties (Tie_configuration const &first,
+                                          Tie_configuration const &last,
+                                          Ties_configuration *ties_conf) const
+{
+  Real penalty = 0.0;
+  Real p = details_.outer_tie_length_symmetry_penalty_factor_
+           * fabs (first.attachment_x_.length () - last.attachment_x_.length ());
+  if (ties_conf)
+    ties_conf->add_score (p, "length symm");
+  else
+    penalty += p;
+
+  p = details_.outer_tie_vertical_distance_symmetry_penalty_factor_
+      * fabs (fabs (specifications_[0].position_ * 0.5 * details_.staff_space_
+                    - (first.position_ * 0.5 * details_.staff_space_
+                       + first.delta_y_))
+              -
+              fabs (specifications_.back ().position_ * 0.5 * details_.staff_space_
+                    - (last.position_ * 0.5 * details_.staff_space_
+                       + last.delta_y_)));
+  if (ties_conf)
+    ties_conf->add_score (p, "pos symmetry");
+  else
+    penalty += p;
+
+  return penalty;
+}
+
+Tie_score_components::Tie_score_components ()
+{
+  outer_score_ = 0.0;
+}
+
+Real
+Tie_score_components::total () const
+{
+  Real sum = outer_score_;
+  for (vsize i = 0; i < tie_scores_.size (); i++)
+    sum += tie_scores_[i];
+  for (vsize i = 0; i < adjacent_scores_.size (); i++)
+    sum += adjacent_scores_[i];
+  return sum;
+}
+
+/*
+  Score TIES for the variation search, keeping the demerits of each
+  tie and of each adjacent pair apart so that a variation only has to
+  rescore what it touches.  Only for chords; a single tie also scores
+  against its stems, which is done in score_ties_aptitude ().
+ */
+Tie_score_components
+Tie_formatting_problem::score_ties_components (Ties_configuration *ties) const
+{
+  Tie_score_components comps;
+  comps.tie_scores_.resize (ties->size (), 0.0);
+  comps.adjacent_scores_.resize (ties->size (), 0.0);
+
+  vector<bool> all (ties->size (), true);
+  rescore_ties_components (ties, all, &comps);
+  return comps;
+}
+
+/*
+  Recompute the components of COMPS that depend on the ties marked in
+  CHANGED.
+ */
+void
+Tie_formatting_problem::rescore_ties_components (Ties_configuration *ties,
+                                                 vector<bool> const &changed,
+                                                 Tie_score_components *comps) const
+{
+  vsize n = ties->size ();
+  for (vsize i = 0; i < n; i++)
     {
-      Bezier b (ties->at (i).get_transformed_bezier (details_));
+      if (!changed[i])
+        continue;
 
-      Real center = b.curve_point (0.5)[Y_AXIS];
-      Real edge = b.curve_point (0.0)[Y_AXIS];
+      Tie_configuration *conf = &ties->at (i);
+      score_configuration (conf);
+      comps->tie_scores_[i] = conf->score ()
+                              + score_aptitude (conf, specifications_[i], 0, i);
+    }
 
-      if (i)
+  for (vsize i = 1; i < n; i++)
+    if (changed[i - 1] || changed[i])
+      comps->adjacent_scores_[i] = score_adjacent_ties (ties->at (i - 1),
+                                                        ties->at (i), 0);
+
+  if (n > 1 && (changed[0] || changed[n - 1]))
+    comps->outer_score_ = score_outer_ties (ties->at (0), ties->back (), 0);
+}
+
+/*
+  Depth-first search over combinations of at most DEPTH variations,
+  each tie being changed by at most one of them.  Variations are
+  applied in place to TIES and undone afterwards.
+
+  All demerits are non-negative, so the components that no remaining
+  variation can touch (REACH[FIRST] lists the ties the variations from
+  FIRST on can change) bound the score of every configuration below
+  this node; subtrees that cannot beat BEST_SCORE are pruned.
+ */
+void
+Tie_formatting_problem::search_variations (Ties_configuration *ties,
+                                           Tie_score_components *comps,
+                                           vector<Tie_configuration_variation> const &vars,
+                                           vector<vector<bool> > const &reach,
+                                           vsize first, int depth,
+                                           vector<bool> *touched,
+                                           vector<vsize> *path,
+                                           Real *best_score,
+                                           vector<vsize> *best_path) const
+{
+  vsize n = ties->size ();
+  for (vsize v = first; v < vars.size (); v++)
+    {
+      vector<pair<int, Tie_configuration *> > const &subst
+        = vars[v].index_suggestion_pairs_;
+
+      bool overlaps = false;
+      for (vsize j = 0; j < subst.size (); j++)
+        overlaps = overlaps || (*touched)[subst[j].first];
+      if (overlaps)
+        continue;
+
+      vector<Tie_configuration> saved_ties;
+      Tie_score_components saved_comps (*comps);
+      vector<bool> changed (n, false);
+      for (vsize j = 0; j < subst.size (); j++)
         {
-          if (edge <= last_edge)
-            ties->add_score (details_.tie_column_monotonicity_penalty_, "monoton edge");
-          if (center <= last_center)
-            ties->add_score (details_.tie_column_monotonicity_penalty_, "monoton cent");
-
-          ties->add_score (details_.tie_tie_collision_penalty_ *
-                           peak_around (0.1 * details_.tie_tie_collision_distance_,
-                                        details_.tie_tie_collision_distance_,
-                                        fabs (center - last_center)),
-                           "tietie center");
-          ties->add_score (details_.tie_tie_collision_penalty_ *
-                           peak_around (0.1 * details_.tie_tie_collision_distance_,
-                                        details_.tie_tie_collision_distance_,
-                                        fabs (edge - last_edge)), "tietie edge");
+          int idx = subst[j].first;
+          saved_ties.push_back ((*ties)[idx]);
+          score_configuration (subst[j].second);
+          (*ties)[idx] = *subst[j].second;
+          changed[idx] = true;
+          (*touched)[idx] = true;
         }
 
-      last_edge = edge;
-      last_center = center;
-    }
+      rescore_ties_components (ties, changed, comps);
+      path->push_back (v);
 
-  if (ties->size () > 1)
-    {
-      ties->add_score (details_.outer_tie_length_symmetry_penalty_factor_
-                       * fabs (ties->at (0).attachment_x_.length () - ties->back ().attachment_x_.length ()),
-                       "length symm");
-
-      ties->add_score (details_.outer_tie_vertical_distance_symmetry_penalty_factor_
-                       * fabs (fabs (specifications_[0].position_ * 0.5 * details_.staff_space_
-                                     - (ties->at (0).position_ * 0.5 * details_.staff_space_
-                                        + ties->at (0).delta_y_))
-                               -
-                               fabs (specifications_.back ().position_ * 0.5 * details_.staff_space_
-                                     - (ties->back ().position_ * 0.5 * details_.staff_space_
-                                        + ties->back ().delta_y_))),
-                       "pos symmetry");
+      Real score = comps->total ();
+      if (score < *best_score)
+        {
+          *best_score = score;
+          *best_path = *path;
+        }
+
+      if (depth > 1 && v + 1 < vars.size ())
+        {
+          vector<bool> const &free = reach[v + 1];
+          Real bound = 0.0;
+          for (vsize i = 0; i < n; i++)
+            {
+              if (!free[i] || (*touched)[i])
+                bound += comps->tie_scores_[i];
+              if (i && (!free[i - 1] || (*touched)[i - 1])
+                  && (!free[i] || (*touched)[i]))
+                bound += comps->adjacent_scores_[i];
+            }
+          if ((!free[0] || (*touched)[0])
+              && (!free[n - 1] || (*touched)[n - 1]))
+            bound += comps->outer_score_;
+
+          if (bound < *best_score)
+            search_variations (ties, comps, vars, reach, v + 1, depth - 1,
+                               touched, path, best_score, best_path);
+        }
+
+      path->pop_back ();
+      for (vsize j = 0; j < subst.size (); j++)
+        {
+          (*touched)[subst[j].first] = false;
+          (*ties)[subst[j].first] = saved_ties[j];
+        }
+      *comps = saved_comps;
     }
 }
 
@@ -921,16 +1117,15 @@ Tie_formatting_problem::generate_base_chord_configuration ()
   return ties_config;
 }
 
+/*
+  This simply is 1-opt: we have K substitions, and we try applying
+  exactly every one for each.
+*/
 Ties_configuration
-Tie_formatting_problem::find_best_variation (Ties_configuration const &base,
-                                             vector<Tie_configuration_variation> const &vars)
+Tie_formatting_problem::find_best_single_variation (Ties_configuration const &base,
+                                                    vector<Tie_configuration_variation> const &vars)
 {
   Ties_configuration best = base;
-
-  /*
-    This simply is 1-opt: we have K substitions, and we try applying
-    exactly every one for each.
-  */
   for (vsize i = 0; i < vars.size (); i++)
     {
       Ties_configuration variant (base);
@@ -941,11 +1136,73 @@ Tie_formatting_problem::find_best_variation (Ties_configuration const &base,
       score_ties (&variant);
 
       if (variant.score () < best.score ())
+        best = variant;
+    }
+
+  return best;
+}
+
+Ties_configuration
+Tie_formatting_problem::find_best_variation (Ties_configuration const &base,
+                                             vector<Tie_configuration_variation> const &vars)
+{
+  if (base.size () < 2)
+    return find_best_single_variation (base, vars);
+
+  Ties_configuration best = base;
+
+  /*
+    For chords, combine up to variation-search-depth substitutions
+    (1 is plain 1-opt), rescoring only the ties a substitution touches
+    and their neighbors.
+  */
+  vsize n = base.size ();
+  vector<vector<bool> > reach (vars.size () + 1, vector<bool> (n, false));
+  for (vsize v = vars.size (); v--;)
+    {
+      reach[v] = reach[v + 1];
+      for (vsize j = 0; j < vars[v].index_suggestion_pairs_.size (); j++)
+        reach[v][vars[v].index_suggestion_pairs_[j].first] = true;
+    }
+
+  Ties_configuration current (base);
+  Tie_score_components comps = score_ties_components (&current);
+  Real best_score = comps.total ();
+
+  vector<bool> touched (n, false);
+  vector<vsize> path;
+  vector<vsize> best_path;
+  search_variations (&current, &comps, vars, reach, 0,
+                     max (details_.variation_search_depth_, 1),
+                     &touched, &path, &best_score, &best_path);
+
+  if (!best_path.empty ())
+    {
+      for (vsize i = 0; i < best_path.size (); i++)
         {
-          best = variant;
+          Tie_configuration_variation const &var = vars[best_path[i]];
+          for (vsize j = 0; j < var.index_suggestion_pairs_.size (); j++)
+            best[var.index_suggestion_pairs_[j].first] = *var.index_suggestion_pairs_[j].second;
         }
+
+      /* Full rescore, for the score cards of debug-tie-scoring.  */
+      best.reset_score ();
+      score_ties (&best);
     }
 
+  /*
+    The search includes every single variation, so it should never do
+    worse than 1-opt.  Check this on request, since it doubles the
+    work.
+  */
+  if (get_program_option ("check-tie-variation-search"))
+    {
+      Ties_configuration one_opt = find_best_single_variation (base, vars);
+      if (best.score () > one_opt.score () + 1e-6 * max (fabs (one_opt.score ()), 1.0))
+        programming_error (_f ("tie variation search: demerits %f exceed"
+                               " 1-opt demerits %f",
+                               best.score (), one_opt.score ()));
+    }
   return best;
 }
 
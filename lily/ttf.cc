@@ -576,3 +576,37 @@ LY_DEFINE (ly_ttf_2_pfa, "ly:ttf->pfa",
 
   return asscm;
 }
+
+LY_DEFINE (ly_ttf_glyph_indices, "ly:ttf-glyph-indices",
+           2, 1, 0, (SCM ttf_file_name, SCM glyph_names, SCM idx),
+           "Return the list of glyph indices of the glyphs named"
+           " @var{glyph-names} in a TrueType font.  Besides names from"
+           " the font, the names @code{glyphIndex@var{XX}},"
+           " @code{uni@var{XXXX}} and @code{u@var{XXXXX}} created"
+           " for fonts without glyph names are understood.  Unknown"
+           " glyphs have index@tie{}0.  The optional @var{idx} argument"
+           " specifies the font index within a TrueType collection (TTC).")
+{
+  LY_ASSERT_TYPE (scm_is_string, ttf_file_name, 1);
+
+  int i = 0;
+  if (!SCM_UNBNDP (idx))
+    {
+      LY_ASSERT_TYPE (scm_is_integer, idx, 3);
+      i = max (scm_to_int (idx), 0);
+    }
+
+  FT_Face face = open_ft_face (ly_scm2string (ttf_file_name), i);
+
+  SCM result = SCM_EOL;
+  for (SCM s = glyph_names; scm_is_pair (s); s = scm_cdr (s))
+    {
+      FT_UInt gid = ly_FT_name_to_index (face,
+                                         ly_scm2string (scm_car (s)));
+      result = scm_cons (scm_from_uint (gid), result);
+    }
+
+  FT_Done_Face (face);
+
+  return scm_reverse_x (result, SCM_EOL);
+}
@@ -127,6 +127,24 @@
                     #:pixmap-format (ly:get-option 'pixmap-format))
     (ly:progress "\n")))
 
+(define-public (stencils->png paper stencils x-ext y-ext
+                              base-name resolution)
+  "Rasterize the region @var{x-ext} by @var{y-ext} of @var{stencils}
+with the built-in renderer.  A single stencil is written to
+@var{base-name}@file{.png}, several go to
+@var{base-name}@file{-page}@var{n}@file{.png}, as with Ghostscript."
+  (let ((multi-page? (> (length stencils) 1)))
+    (ly:message (_ "Converting to ~a...") "PNG")
+    (for-each
+     (lambda (stencil n)
+       (ly:stencil->png paper stencil x-ext y-ext resolution
+                        (if multi-page?
+                            (format #f "~a-page~a.png" base-name n)
+                            (format #f "~a.png" base-name))))
+     stencils
+     (iota (length stencils) 1))
+    (ly:progress "\n")))
+
 (define-public (postscript->ps base-name tmp-name is-eps)
   (let* ((ps-name (string-append base-name
                                  (if is-eps ".eps" ".ps"))))
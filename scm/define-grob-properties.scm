@@ -1408,7 +1408,8 @@ of the group are @code{cross-staff}.")
      (ideal-distances ,list? "@code{(@var{obj} . (@var{dist} .
 @var{strength}))} pairs.")
      (important-column-ranks ,vector? "A cache of columns that contain
-@code{items-worth-living} data.")
+@code{items-worth-living} data.  Element@tie{}@var{r} is the number of
+such columns with a rank below@tie{}@var{r}.")
      (interfaces ,list? "A list of symbols indicating the interfaces
 supported by this object.  It is initialized from the @code{meta} field.")
 
@@ -0,0 +1,546 @@
+;;;; This file is part of LilyPond, the GNU music typesetter.
+;;;;
+;;;; Copyright (C) 2026 The LilyPond development team
+;;;;
+;;;; LilyPond is free software: you can redistribute it and/or modify
+;;;; it under the terms of the GNU General Public License as published by
+;;;; the Free Software Foundation, either version 3 of the License, or
+;;;; (at your option) any later version.
+;;;;
+;;;; LilyPond is distributed in the hope that it will be useful,
+;;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;;; GNU General Public License for more details.
+;;;;
+;;;; You should have received a copy of the GNU General Public License
+;;;; along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+
+;;;; Write PDF files directly, without going through PostScript and
+;;;; Ghostscript.
+;;;;
+;;;; Reference:
+;;;; PDF Reference, sixth edition (PDF 1.7), Adobe Systems, 2006.
+;;;;
+;;;; This backend is experimental.  TODO:
+;;;;   * write objects into object streams, with a cross-reference
+;;;;     stream (PDF 1.5).  Every object is written on its own now,
+;;;;     with a classic cross-reference table.
+;;;;   * subset TrueType and Type 1 fonts; they are embedded whole.
+;;;;   * compare page counts, text and rasterized pages with the
+;;;;     PostScript backend over input/regression, using
+;;;;     scripts/auxiliar/compare-pdf-backends.sh.
+
+(define-module (scm framework-pdf))
+
+(use-modules
+ (guile)
+ (lily)
+ (scm page)
+ (scm paper-system)
+ (scm output-pdf)
+ (srfi srfi-1)
+ (srfi srfi-13))
+
+(define format ergonomic-simple-format)
+
+;;;
+;;; Object store
+;;;
+
+;; Objects are numbered as they are allocated and written in order.
+;; Object 0 is the free list head required by the xref table.
+(define object-count 0)
+(define object-bodies (make-hash-table 101))
+
+(define (new-object!)
+  (set! object-count (1+ object-count))
+  object-count)
+
+(define (set-object! number body)
+  (hash-set! object-bodies number body))
+
+(define (add-object! body)
+  (let ((number (new-object!)))
+    (set-object! number body)
+    number))
+
+(define (ref number)
+  (format #f "~a 0 R" number))
+
+(define (stream-object dict data)
+  "A stream with DATA, deflated unless LilyPond lacks zlib."
+  (let* ((deflated (ly:deflate data))
+         (data (or deflated data)))
+    (string-append "<<" dict
+                   (if deflated " /Filter /FlateDecode" "")
+                   " /Length " (number->string (string-length data))
+                   " >>\nstream\n" data "\nendstream")))
+
+(define (pdf-quote str)
+  "Quote STR for use in a PDF string literal."
+  (string-concatenate
+   (map (lambda (c)
+          (case c
+            ((#\\) "\\\\")
+            ((#\() "\\(")
+            ((#\)) "\\)")
+            ((#\cr) "\\r")
+            (else (string c))))
+        (string->list str))))
+
+(define (pdf-name str)
+  "Return STR as a PDF name, escaping delimiters and non-printing
+characters."
+  (string-append
+   "/"
+   (string-concatenate
+    (map (lambda (c)
+           (let ((i (char->integer c)))
+             (if (or (< i 33) (> i 126)
+                     (memv c '(#\# #\/ #\( #\) #\< #\> #\[ #\] #\{ #\} #\%)))
+                 (string-append
+                  "#" (string-pad (number->string i 16) 2 #\0))
+                 (string c))))
+         (string->list str)))))
+
+;;;
+;;; Coordinates
+;;;
+
+;; A transformation is a list (a b c d e f) mapping (x, y) to
+;; (ax + cy + e, bx + dy + f), like the PDF `cm' operator.
+
+(define (matrix-multiply m n)
+  "The transformation applying M first, then N."
+  (let ((a (first m)) (b (second m)) (c (third m))
+        (d (fourth m)) (e (fifth m)) (f (sixth m)))
+    (list (+ (* a (first n)) (* b (third n)))
+          (+ (* a (second n)) (* b (fourth n)))
+          (+ (* c (first n)) (* d (third n)))
+          (+ (* c (second n)) (* d (fourth n)))
+          (+ (* e (first n)) (* f (third n)) (fifth n))
+          (+ (* e (second n)) (* f (fourth n)) (sixth n)))))
+
+(define (transform-point m x y)
+  (cons (+ (* (first m) x) (* (third m) y) (fifth m))
+        (+ (* (second m) x) (* (fourth m) y) (sixth m))))
+
+(define (transform-rect m llx lly urx ury)
+  (let ((p (transform-point m llx lly))
+        (q (transform-point m urx ury)))
+    (list (min (car p) (car q)) (min (cdr p) (cdr q))
+          (max (car p) (car q)) (max (cdr p) (cdr q)))))
+
+;;;
+;;; Pages
+;;;
+
+;; A rendered page is a vector #(CONTENT LINKS WIDTH HEIGHT MATRIX).
+
+(define (render-page paper stencil width height matrix)
+  (let* ((port (open-output-string))
+         (outputter (ly:make-paper-outputter port 'pdf))
+         (content #f))
+    (ly:outputter-output-scheme
+     outputter
+     `(begin (set! output-scale ,(ly:output-def-lookup paper 'output-scale))
+             ""))
+    (ly:outputter-dump-string outputter (ly:format "~4l cm\n" matrix))
+    (ly:outputter-dump-stencil outputter stencil)
+    (set! content (get-output-string port))
+    (ly:outputter-close outputter)
+    (vector content (pdf-take-page-links) width height matrix)))
+
+(define (page-geometry paper)
+  "Return (WIDTH HEIGHT MATRIX) for a full page of PAPER, in big points."
+  (let* ((lookup (lambda (x) (ly:output-def-lookup paper x)))
+         (scale (/ (lookup 'output-scale) (ly:bp 1)))
+         (w (* scale (lookup 'paper-width)))
+         (h (* scale (lookup 'paper-height)))
+         (page (list scale 0 0 scale 0 h)))
+    ;; Mirror the PostScript page setup of framework-ps.scm.
+    (if (eq? (lookup 'landscape) #t)
+        (list h w (matrix-multiply page (list 0 1 -1 0 w 0)))
+        (list w h page))))
+
+(define (link-annotation page-refs link matrix)
+  (let ((target (first link))
+        (rect (apply transform-rect matrix (cdr link))))
+    (cond
+     ((string? target)
+      (ly:format "<< /Type /Annot /Subtype /Link /Rect [~4l] /Border [0 0 0] /A << /S /URI /URI (~a) >> >>"
+                 rect (pdf-quote target)))
+     ((and (integer? target) (< 0 target (1+ (length page-refs))))
+      (ly:format "<< /Type /Annot /Subtype /Link /Rect [~4l] /Border [0 0 0] /Dest [~a /XYZ null null null] >>"
+                 rect (ref (list-ref page-refs (1- target)))))
+     (else #f))))
+
+;;;
+;;; Fonts
+;;;
+
+(define ascii-glyph-names
+  '(("space" . 32) ("exclam" . 33) ("quotedbl" . 34) ("numbersign" . 35)
+    ("dollar" . 36) ("percent" . 37) ("ampersand" . 38)
+    ("quotesingle" . 39) ("quoteright" . 39) ("parenleft" . 40)
+    ("parenright" . 41) ("asterisk" . 42) ("plus" . 43) ("comma" . 44)
+    ("hyphen" . 45) ("period" . 46) ("slash" . 47) ("zero" . 48)
+    ("one" . 49) ("two" . 50) ("three" . 51) ("four" . 52) ("five" . 53)
+    ("six" . 54) ("seven" . 55) ("eight" . 56) ("nine" . 57)
+    ("colon" . 58) ("semicolon" . 59) ("less" . 60) ("equal" . 61)
+    ("greater" . 62) ("question" . 63) ("at" . 64) ("bracketleft" . 91)
+    ("backslash" . 92) ("bracketright" . 93) ("asciicircum" . 94)
+    ("underscore" . 95) ("grave" . 96) ("quoteleft" . 96)
+    ("braceleft" . 123) ("bar" . 124) ("braceright" . 125)
+    ("asciitilde" . 126)))
+
+(define (glyph-name->unicode name)
+  "Guess the Unicode code point of glyph NAME, or #f."
+  (let* ((dot (string-index name #\.))
+         (base (if (and dot (> dot 0)) (substring name 0 dot) name))
+         (len (string-length base)))
+    (cond
+     ((and (= len 7) (string-prefix? "uni" base))
+      (string->number (substring base 3) 16))
+     ((and (<= 5 len 7) (string-prefix? "u" base))
+      (string->number (substring base 1) 16))
+     ((and (= len 1) (char-alphabetic? (string-ref base 0)))
+      (char->integer (string-ref base 0)))
+     (else (assoc-ref ascii-glyph-names base)))))
+
+(define (to-unicode-cmap glyphs digits)
+  "A ToUnicode CMap for GLYPHS, a list of (CODE NAME . WIDTH), with
+codes of DIGITS hex digits."
+  (let* ((mapped (filter-map
+                  (lambda (g)
+                    (let ((u (glyph-name->unicode (cadr g))))
+                      (and u (< 0 u #x10000)
+                           (format #f "<~a> <~a>\n"
+                                   (string-pad (number->string
+                                                (if (= digits 2)
+                                                    (remainder (car g) 256)
+                                                    (car g))
+                                                16)
+                                               digits #\0)
+                                   (string-pad (number->string u 16)
+                                               4 #\0)))))
+                  glyphs)))
+    (define (blocks entries)
+      (if (null? entries)
+          ""
+          (let ((n (min 100 (length entries))))
+            (string-append
+             (format #f "~a beginbfchar\n" n)
+             (string-concatenate (take entries n))
+             "endbfchar\n"
+             (blocks (drop entries n))))))
+    (and (pair? mapped)
+         (string-append
+          "/CIDInit /ProcSet findresource begin\n"
+          "12 dict begin\n"
+          "begincmap\n"
+          "/CIDSystemInfo << /Registry (Adobe) /Ordering (UCS) /Supplement 0 >> def\n"
+          "/CMapName /Adobe-Identity-UCS def\n"
+          "/CMapType 2 def\n"
+          "1 begincodespacerange\n"
+          (if (= digits 2) "<00> <FF>\n" "<0000> <FFFF>\n")
+          "endcodespacerange\n"
+          (blocks mapped)
+          "endcmap\n"
+          "CMapName currentdict /CMap defineresource pop\n"
+          "end\n"
+          "end"))))
+
+(define (subset-base-name font)
+  "The base name of FONT with the six-letter tag that marks a subset
+font, unique within the file."
+  (string-append
+   (list->string
+    (map (lambda (i)
+           (integer->char
+            (+ 65 (remainder (quotient (pdf-font-id font) (expt 26 i)) 26))))
+         (iota 6 5 -1)))
+   "+" (pdf-font-base-name font)))
+
+(define (font-descriptor base-name file-key file-ref)
+  (add-object!
+   (string-append
+    "<< /Type /FontDescriptor"
+    " /FontName /" base-name
+    " /Flags 4 /FontBBox [-1000 -1000 2000 2000] /ItalicAngle 0"
+    " /Ascent 0 /Descent 0 /CapHeight 0 /StemV 0"
+    (if file-ref (format #f " /~a ~a" file-key (ref file-ref)) "")
+    " >>")))
+
+(define (slices glyphs)
+  "Split GLYPHS, sorted by code, into lists of 256."
+  (if (null? glyphs)
+      '()
+      (let ((n (min 256 (length glyphs))))
+        (cons (take glyphs n) (slices (drop glyphs n))))))
+
+(define (write-font-file font glyphs)
+  "The font file object for the simple font FONT, embedding the CFF
+glyphs GLYPHS only if subsetting.  Return (FILE-KEY OBJECT SUBSET?)."
+  (let* ((program (pdf-font-program font))
+         (data (cdr program)))
+    (case (car program)
+      ((cff)
+       (if (string-null? data)
+           (list "FontFile3" #f #f)
+           (let ((subset? (ly:get-option 'subset-fonts)))
+             (list "FontFile3"
+                   (add-object!
+                    (stream-object
+                     " /Subtype /Type1C"
+                     (if subset?
+                         (ly:cff-subset data
+                                        (pdf-font-glyph-indices
+                                         font (map cadr glyphs)))
+                         data)))
+                   subset?))))
+      ((type1)
+       (list "FontFile"
+             (add-object!
+              (stream-object
+               (apply format #f " /Length1 ~a /Length2 ~a /Length3 ~a"
+                      (map string-length data))
+               (string-concatenate data)))
+             #f))
+      (else (list "FontFile3" #f #f)))))
+
+(define (write-simple-font font)
+  "Objects for a name-keyed CFF or Type 1 font.  Return an alist of
+resource names and font object numbers."
+  (let* ((file (write-font-file font (pdf-font-used-glyphs font)))
+         (base-name (if (third file)
+                        (subset-base-name font)
+                        (pdf-font-base-name font)))
+         (descriptor (font-descriptor base-name (first file) (second file))))
+    (map
+     (lambda (slice index)
+       (let ((to-unicode (to-unicode-cmap slice 2)))
+         (cons
+          (pdf-font-resource-name font index)
+          (add-object!
+           (string-append
+            "<< /Type /Font /Subtype /Type1"
+            " /BaseFont /" base-name
+            " /FirstChar 0"
+            (format #f " /LastChar ~a" (1- (length slice)))
+            " /Widths [" (string-join (map (lambda (g)
+                                             (number->string
+                                              (inexact->exact (cddr g))))
+                                           slice))
+            "]"
+            " /Encoding << /Type /Encoding /Differences [0 "
+            (string-join (map (lambda (g) (pdf-name (cadr g))) slice))
+            "] >>"
+            " /FontDescriptor " (ref descriptor)
+            (if to-unicode
+                (string-append " /ToUnicode "
+                               (ref (add-object!
+                                     (stream-object "" to-unicode))))
+                "")
+            " >>")))))
+     (slices (pdf-font-used-glyphs font))
+     (iota (length (slices (pdf-font-used-glyphs font)))))))
+
+(define (write-cid-font font)
+  "Objects for a TrueType font addressed by glyph index.  Return an
+alist of resource names and font object numbers."
+  (let* ((program (cdr (pdf-font-program font)))
+         (file-ref (and (string? program) (not (string-null? program))
+                        (add-object!
+                         (stream-object
+                          (format #f " /Length1 ~a" (string-length program))
+                          program))))
+         (descriptor (font-descriptor (pdf-font-base-name font)
+                                      "FontFile2" file-ref))
+         (glyphs (sort (pdf-font-used-glyphs font)
+                       (lambda (a b) (< (car a) (car b)))))
+         (widths (string-concatenate
+                  (map (lambda (g)
+                         (format #f " ~a [~a]"
+                                 (car g) (inexact->exact (cddr g))))
+                       glyphs)))
+         (cid-font
+          (add-object!
+           (string-append
+            "<< /Type /Font /Subtype /CIDFontType2"
+            " /BaseFont /" (pdf-font-base-name font)
+            " /CIDSystemInfo << /Registry (Adobe) /Ordering (Identity) /Supplement 0 >>"
+            " /FontDescriptor " (ref descriptor)
+            " /CIDToGIDMap /Identity"
+            " /W [" widths " ] >>")))
+         (to-unicode (to-unicode-cmap glyphs 4)))
+    (list
+     (cons (pdf-font-resource-name font 0)
+           (add-object!
+            (string-append
+             "<< /Type /Font /Subtype /Type0"
+             " /BaseFont /" (pdf-font-base-name font)
+             " /Encoding /Identity-H"
+             " /DescendantFonts [" (ref cid-font) "]"
+             (if to-unicode
+                 (string-append " /ToUnicode "
+                                (ref (add-object!
+                                      (stream-object "" to-unicode))))
+                 "")
+             " >>"))))))
+
+;;;
+;;; Document
+;;;
+
+(define (info-dictionary header)
+  (define (info-entry overridevar fallbackvar field)
+    (let* ((overrideval (ly:modules-lookup (list header) overridevar))
+           (fallbackval (ly:modules-lookup (list header) fallbackvar))
+           (val (if overrideval overrideval fallbackval)))
+      (if val
+          (format #f " /~a (~a)\n" field
+                  (pdf-quote
+                   (ly:encode-string-for-pdf
+                    (markup->string val (list header)))))
+          "")))
+
+  (string-append
+   "<<\n"
+   (format #f " /Creator (LilyPond ~a)\n" (lilypond-version))
+   (if (module? header)
+       (string-append
+        (info-entry 'pdfauthor 'author "Author")
+        (info-entry 'pdftitle 'title "Title")
+        (info-entry 'pdfsubject 'subject "Subject")
+        (info-entry 'pdfkeywords 'keywords "Keywords")
+        (info-entry 'pdfmodDate 'modDate "ModDate")
+        (info-entry 'pdfsubtitle 'subtitle "Subtitle")
+        (info-entry 'pdfcomposer 'composer "Composer")
+        (info-entry 'pdfarranger 'arranger "Arranger")
+        (info-entry 'pdfpoet 'poet "Poet")
+        (info-entry 'pdfcopyright 'copyright "Copyright"))
+       "")
+   ">>"))
+
+(define (write-pdf filename header pages)
+  "Write PAGES, a list of rendered pages, to FILENAME."
+  (set! object-count 0)
+  (set! object-bodies (make-hash-table 101))
+  (let* ((catalog (new-object!))
+         (pages-obj (new-object!))
+         (info (add-object! (info-dictionary header)))
+         (resources (new-object!))
+         (page-refs (map (lambda (p) (new-object!)) pages)))
+
+    (for-each
+     (lambda (page page-ref)
+       (let* ((content (add-object! (stream-object "" (vector-ref page 0))))
+              (matrix (vector-ref page 4))
+              (annots (filter-map
+                       (lambda (l) (link-annotation page-refs l matrix))
+                       (vector-ref page 1))))
+         (set-object!
+          page-ref
+          (string-append
+           "<< /Type /Page /Parent " (ref pages-obj)
+           (ly:format " /MediaBox [0 0 ~4f ~4f]"
+                      (vector-ref page 2) (vector-ref page 3))
+           " /Resources " (ref resources)
+           " /Contents " (ref content)
+           (if (pair? annots)
+               (string-append " /Annots [" (string-join annots "\n") "]")
+               "")
+           " >>"))))
+     pages page-refs)
+
+    (let ((font-refs
+           (append-map (lambda (font)
+                         (if (eq? (pdf-font-kind font) 'simple)
+                             (write-simple-font font)
+                             (write-cid-font font)))
+                       (pdf-fonts))))
+      (set-object!
+       resources
+       (string-append
+        "<< /ProcSet [/PDF /Text] /Font <<"
+        (string-concatenate
+         (map (lambda (f) (format #f " /~a ~a" (car f) (ref (cdr f))))
+              font-refs))
+        " >> >>")))
+
+    (set-object! pages-obj
+                 (format #f "<< /Type /Pages /Kids [~a] /Count ~a >>"
+                         (string-join (map ref page-refs))
+                         (length page-refs)))
+    (set-object! catalog
+                 (format #f "<< /Type /Catalog /Pages ~a >>" (ref pages-obj)))
+
+    (let ((port (open-file filename "wb"))
+          (offsets (make-vector (1+ object-count) 0))
+          (position 0))
+      (define (emit str)
+        (display str port)
+        (set! position (+ position (string-length str))))
+
+      (ly:message (_ "Writing ~a...") filename)
+      ;; The binary comment marks the file as binary for transfer
+      ;; programs.
+      (emit (string-append "%PDF-1.4\n%"
+                           (list->string (map integer->char
+                                              '(#xe2 #xe3 #xcf #xd3)))
+                           "\n"))
+      (for-each
+       (lambda (n)
+         (vector-set! offsets n position)
+         (emit (format #f "~a 0 obj\n" n))
+         (emit (hash-ref object-bodies n))
+         (emit "\nendobj\n"))
+       (iota object-count 1))
+      (let ((xref position))
+        (emit (format #f "xref\n0 ~a\n0000000000 65535 f \n"
+                      (1+ object-count)))
+        (for-each
+         (lambda (n)
+           (emit (string-append
+                  (string-pad (number->string (vector-ref offsets n)) 10 #\0)
+                  " 00000 n \n")))
+         (iota object-count 1))
+        (emit (format #f "trailer\n<< /Size ~a /Root ~a /Info ~a >>\nstartxref\n~a\n%%EOF\n"
+                      (1+ object-count) (ref catalog) (ref info) xref)))
+      (close-port port)
+      (ly:progress "\n")))
+  (set! object-bodies (make-hash-table 1)))
+
+(define (output-framework basename book scopes fields)
+  (let* ((paper (ly:paper-book-paper book))
+         (geometry (page-geometry paper))
+         (page-stencils (map page-stencil (ly:paper-book-pages book))))
+    (pdf-reset-fonts)
+    (write-pdf (format #f "~a.pdf" basename)
+               (ly:paper-book-header book)
+               (map (lambda (stencil)
+                      (apply render-page paper stencil geometry))
+                    page-stencils))
+    (pdf-reset-fonts)))
+
+(define (output-preview-framework basename book scopes fields)
+  (let* ((paper (ly:paper-book-paper book))
+         (systems (relevant-book-systems book))
+         (to-dump-systems (relevant-dump-systems systems))
+         (stencil (stack-stencils Y DOWN 0.0
+                                  (map paper-system-stencil
+                                       (reverse to-dump-systems))))
+         (x-extent (ly:stencil-extent stencil X))
+         (y-extent (ly:stencil-extent stencil Y))
+         (scale (/ (ly:output-def-lookup paper 'output-scale) (ly:bp 1))))
+    (pdf-reset-fonts)
+    (write-pdf (format #f "~a.preview.pdf" basename)
+               (ly:paper-book-header book)
+               (list (render-page paper stencil
+                                  (* scale (interval-length x-extent))
+                                  (* scale (interval-length y-extent))
+                                  (list scale 0 0 scale
+                                        (* scale (- (car x-extent)))
+                                        (* scale (- (car y-extent)))))))
+    (pdf-reset-fonts)))
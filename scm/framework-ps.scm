@@ -216,9 +216,81 @@
 
 (define never-embed-font-list (list))
 
+;; Font data prepared for embedding, shared by all documents written
+;; by this process.  Keys are (FILE-NAME MTIME FONT-INDEX KIND), so an
+;; edited font file is read again.
+(define font-data-cache (make-hash-table 31))
+
+(define (cached-font-data file-name font-index kind thunk)
+  (let* ((mtime (and (string? file-name)
+                     (file-exists? file-name)
+                     (stat:mtime (stat file-name))))
+         (key (list file-name mtime font-index kind)))
+    (or (hash-ref font-data-cache key)
+        (let ((data (thunk)))
+          (hash-set! font-data-cache key data)
+          data))))
+
+(define (otf-font-file font)
+  (let ((name (ly:font-file-name font)))
+    (or (ly:find-file (format #f "~a.otf" name))
+        name)))
+
+(define (font-cff-table font)
+  (cached-font-data (otf-font-file font) 0 'cff-table
+                    (lambda () (ly:otf-font-table-data font "CFF "))))
+
+(define (font-glyph-indices font)
+  (cached-font-data (otf-font-file font) 0 'glyph-indices
+                    (lambda ()
+                      (let ((table (make-hash-table 1031)))
+                        (fold (lambda (name index)
+                                (hash-set! table name index)
+                                (1+ index))
+                              0
+                              (ly:otf-glyph-list font))
+                        table))))
+
 (define (cff-font? font)
-  (let* ((cff-string (ly:otf-font-table-data font "CFF ")))
-    (> (string-length cff-string) 0)))
+  (> (string-length (font-cff-table font)) 0))
+
+(define (subset-fonts?)
+  ;; Exported fonts and --bigpdf output are shared between documents,
+  ;; so they need all glyphs.
+  (and (ly:get-option 'subset-fonts)
+       (not (ly:get-option 'font-export-dir))
+       (not (ly:bigpdfs))))
+
+(define (stencil-glyph-table stencils)
+  "Return a hash table from font file names to hash tables of the
+glyph names that @var{stencils} show with @code{named-glyph}.  Return
+@code{#f} if the stencils contain PostScript code, which might show
+any glyph."
+  (let ((table (make-hash-table 7))
+        (embedded-ps #f))
+    (for-each
+     (lambda (stencil)
+       (ly:interpret-stencil-expression
+        (ly:stencil-expr stencil)
+        (lambda (table expr)
+          (if (eq? (car expr) 'placebox)
+              (let ((prim (cadddr expr)))
+                (cond
+                 ((not (pair? prim)))
+                 ((eq? (car prim) 'named-glyph)
+                  (let* ((key (ly:font-file-name (cadr prim)))
+                         (glyphs (or (hash-ref table key)
+                                     (let ((h (make-hash-table 61)))
+                                       (hash-set! table key h)
+                                       h))))
+                    (hash-set! glyphs (caddr prim) #t)))
+                 ((eq? (car prim) 'embedded-ps)
+                  (set! embedded-ps #t)))))
+          #f)
+        table
+        '(0 . 0)))
+     stencils)
+    (and (not embedded-ps) table)))
 
 (define-public (ps-embed-cff body font-set-name version)
   (let* ((binary-data
@@ -272,7 +344,11 @@
                   (ly:debug (_ "Embedding CFF font `~a'.") name)
                   (set! font-list
                         (acons name-symbol args-filename-offset font-list))
-                  (ps-embed-cff (ly:otf->cff file-name font-index) name 0))))
+                  (ps-embed-cff (cached-font-data
+                                 file-name font-index 'otf->cff
+                                 (lambda ()
+                                   (ly:otf->cff file-name font-index)))
+                                name 0))))
           (begin
             (ly:debug (_ "Initializing embedded CFF font list."))
             (set! font-list '()))))))
@@ -280,7 +356,28 @@
 (define (initialize-font-embedding)
   (check-conflict-and-embed-cff #f #f #f))
 
-(define (write-preamble paper load-fonts? port)
+(define (write-preamble paper load-fonts? port stencils)
+  (define used-glyphs
+    (and load-fonts?
+         (subset-fonts?)
+         (stencil-glyph-table stencils)))
+
+  (define (font-cff-program font)
+    (let ((cff (font-cff-table font)))
+      (if used-glyphs
+          (let ((indices (font-glyph-indices font))
+                (glyphs (or (hash-ref used-glyphs (ly:font-file-name font))
+                            (make-hash-table 1))))
+            (ly:cff-subset cff
+                           (hash-fold (lambda (name dummy result)
+                                        (let ((index (hash-ref indices name)))
+                                          (if index
+                                              (cons index result)
+                                              result)))
+                                      '()
+                                      glyphs)))
+          cff)))
+
   (define (internal-font? font-name-filename)
     (let* ((font (car font-name-filename))
            (file-name (caddr font-name-filename))
@@ -416,10 +513,12 @@
         ;; Type 1 (PFA and PFB) fonts
         (begin (set! never-embed-font-list
                      (append never-embed-font-list (list name)))
-               (ly:type1->pfa file-name)))
+               (cached-font-data file-name font-index 'type1->pfa
+                                 (lambda () (ly:type1->pfa file-name)))))
        ((eq? font-format 'TrueType)
         ;; TrueType fonts (TTF) and TrueType Collection (TTC)
-        (ly:ttf->pfa file-name font-index))
+        (cached-font-data file-name font-index 'ttf->pfa
+                          (lambda () (ly:ttf->pfa file-name font-index))))
        ((eq? font-format 'CFF)
         ;; OpenType/CFF fonts (OTF) and OpenType/CFF Collection (OTC)
         (check-conflict-and-embed-cff name file-name font-index))
@@ -443,7 +542,7 @@
             (cond ((mac-font? bare-file-name)
                    (handle-mac-font name bare-file-name))
                   ((and font (cff-font? font))
-                   (ps-embed-cff (ly:otf-font-table-data font "CFF ")
+                   (ps-embed-cff (font-cff-program font)
                                  name
                                  0))
                   (bare-file-name (font-file-as-ps-string
@@ -679,7 +778,7 @@ mark {ly~a_stream} /CLOSE pdfmark
     (display (file-header paper page-count #t) port)
     ;; don't do BeginDefaults PageMedia: A4
     ;; not necessary and wrong
-    (write-preamble paper #t port)
+    (write-preamble paper #t port page-stencils)
     (handle-metadata header port)
     (for-each
      (lambda (page)
@@ -718,6 +817,17 @@ mark {ly~a_stream} /CLOSE pdfmark
             (car yext) (cdr xext) (cdr yext)))))
     (dump-stencil-as-EPS-with-bbox paper dump-me filename load-fonts bbox)))
 
+;; (EPS-NAME PAPER STENCIL BBOX) for the EPS file written last, so
+;; that native-png can rasterize the stencil instead of the file.
+(define last-eps-dump #f)
+
+(define (take-eps-dump eps-name)
+  (let ((dump last-eps-dump))
+    (set! last-eps-dump #f)
+    (and dump
+         (equal? (car dump) eps-name)
+         (cdr dump))))
+
 (define-public (dump-stencil-as-EPS-with-bbox paper dump-me filename
                                               load-fonts
                                               bbox)
@@ -753,7 +863,7 @@ mark {ly~a_stream} /CLOSE pdfmark
          (header (eps-header paper rounded-bbox load-fonts)))
     (initialize-font-embedding)
     (display header port)
-    (write-preamble paper load-fonts port)
+    (write-preamble paper load-fonts port (list dump-me))
     (display "/mark_page_link { pop pop pop pop pop } bind def\n" port)
     (display "gsave set-ps-scale-to-lily-scale\n" port)
     (display "/helpEmmentaler-Brace where {pop helpEmmentaler-Brace} if\n" port)
@@ -767,7 +877,15 @@ mark {ly~a_stream} /CLOSE pdfmark
     (display "/helpEmmentaler-26 where {pop helpEmmentaler-26} if\n" port)
     (ly:outputter-dump-stencil outputter dump-me)
     (display "stroke grestore\n%%Trailer\n%%EOF\n" port)
-    (ly:outputter-close outputter)))
+    (ly:outputter-close outputter)
+    (if (ly:get-option 'native-png)
+        ;; Use the rounded box, like Ghostscript's EPSCrop.
+        (let ((scale (ly:output-def-lookup paper 'output-scale)))
+          (set! last-eps-dump
+                (list (format #f "~a.eps" filename)
+                      paper dump-me
+                      (map (lambda (x) (/ (* x (ly:bp 1)) scale))
+                           rounded-bbox)))))))
 
 (define (clip-systems-to-region basename paper systems region do-pdf do-png)
   (let* ((extents-system-pairs
@@ -799,8 +917,8 @@ mark {ly~a_stream} /CLOSE pdfmark
          (if do-pdf
              (postscript->pdf 0 0 filename (format #f "~a.eps" filename) #t))
          (if do-png
-             (postscript->png (ly:get-option 'resolution) 0 0
-                              filename (format #f "~a.eps" filename) #t))))
+             (eps->png (ly:get-option 'resolution) 0 0
+                       filename (format #f "~a.eps" filename)))))
      extents-system-pairs)))
 
 (define-public (clip-system-EPSes basename paper-book)
@@ -892,13 +1010,34 @@ mark {ly~a_stream} /CLOSE pdfmark
          (height (cdr width-height)))
     (postscript->pdf width height base-name tmp-name is-eps)))
 
+(define (eps->png resolution width height base-name tmp-name)
+  (let ((dump (and (ly:get-option 'native-png)
+                   (take-eps-dump tmp-name))))
+    (if dump
+        (let ((bbox (caddr dump)))
+          (stencils->png (car dump) (list (cadr dump))
+                         (cons (car bbox) (caddr bbox))
+                         (cons (cadr bbox) (cadddr bbox))
+                         base-name resolution))
+        (postscript->png resolution width height base-name tmp-name #t))))
+
 (define-public (convert-to-png book base-name tmp-name is-eps)
   (let* ((defs (ly:paper-book-paper book))
          (resolution (output-resolution defs))
          (width-height (output-width-height defs))
          (width (car width-height))
          (height (cdr width-height)))
-    (postscript->png resolution width height base-name tmp-name is-eps)))
+    (cond
+     (is-eps
+      (eps->png resolution width height base-name tmp-name))
+     ((ly:get-option 'native-png)
+      ;; Pages are drawn unrotated, also in landscape mode.
+      (stencils->png defs (map page-stencil (ly:paper-book-pages book))
+                     (cons 0 (ly:output-def-lookup defs 'paper-width))
+                     (cons (- (ly:output-def-lookup defs 'paper-height)) 0)
+                     base-name resolution))
+     (else
+      (postscript->png resolution width height base-name tmp-name #f)))))
 
 (define-public (convert-to-ps book base-name tmp-name is-eps)
   (postscript->ps base-name tmp-name is-eps))
@@ -210,6 +210,12 @@ variables to their value after the initial call of @var{thunk}."
     ;; Avoid overlong lines in `lilypond -dhelp'!  Strings should not
     ;; be longer than 48 characters per line.
 
+    (adaptive-gc
+     #f
+     "Scale the GC settings with the input size, and
+grow the heap before layout according to the
+memory used by parsing and translation
+(experimental).")
     (anti-alias-factor 1
                        "Render at higher resolution (using given factor)
 and scale down result to prevent jaggies in
@@ -221,10 +227,19 @@ EPS backend.")
     (backend
      ps
      "Select backend.  Possible values: 'eps, 'null,
-'ps, 'scm, 'socket, 'svg.")
+'pdf, 'ps, 'scm, 'socket, 'svg.")
+    (cache-pure-properties
+     #t
+     "Cache pure heights of spanners during line
+breaking.  Only for debugging.")
     (check-internal-types
      #f
      "Check every property assignment for types.")
+    (check-tie-variation-search
+     #f
+     "Check that the tie chord variation search
+never ends with more demerits than trying each
+variation on its own.  Only for debugging.")
     (clip-systems
      #f
      "Generate cut-out snippets of a score.")
@@ -308,6 +323,12 @@ a log file.")
      #f
      "Process in parallel, using the given number of
 jobs.")
+    (layout-heap-limit
+     #f
+     "If set to N, grow the heap before layout so
+that no garbage collection should be needed,
+as long as the heap stays below N megabytes.
+Requires `adaptive-gc'.")
     (log-file
      #f
      "If string FOO is given as argument, redirect
@@ -317,6 +338,17 @@ output to log file `FOO.log'.")
      "Maximum depth for the markup tree. If a markup has more levels,
 assume it will not terminate on its own, print a warning and return a
 null markup instead.")
+    (memoize-markup
+     #f
+     "Reuse the stencil of a markup that is
+interpreted again with the same properties and
+output definition.  Only valid if no markup
+depends on anything else.")
+    (memory-report
+     #f
+     "Print the number of live objects and their memory
+use for every C++ object type at the start of each processing phase
+and after each file.")
     (midi-extension ,(if (eq? PLATFORM 'windows)
                          "mid"
                          "midi")
@@ -326,6 +358,10 @@ file to given string.")
      #f
      "Convert text strings to paths when glyphs belong
 to a music font.")
+    (native-png
+     #f
+     "Rasterize PNG images with the built-in renderer
+instead of Ghostscript.")
     (point-and-click
      #t
      "Add point & click links to PDF and SVG output.")
@@ -349,6 +385,10 @@ a stack trace.")
     (profile-property-accesses
      #f
      "Keep statistics of get_property() calls.")
+    (quanting-job-count
+     #f
+     "Quant the beams of each system in parallel,
+using the given number of threads.  Experimental.")
     (resolution
      101
      "Set resolution for generating PNG pixmaps to
@@ -387,6 +427,11 @@ constructing output file names.")
 This employs different drawing primitives, resulting in
 large PDF file size increases but often markedly better
 PDF previews.")
+    (subset-fonts
+     #f
+     "Embed only the music font glyphs that are used
+in PostScript output, and only the used CFF font glyphs
+with the pdf backend (experimental).")
     (svg-woff
      #f
      "Use woff font files in SVG backend.")
@@ -400,6 +445,10 @@ second.  Dump results to `FILE.stacks' and
      "Record coverage of Scheme files in `FILE.cov'.")
     (verbose ,(ly:verbose-output?)
              "Verbose output, i.e. loglevel at least DEBUG (read-only).")
+    (verify-parallel-quanting
+     #f
+     "With quanting-job-count, quant every beam
+serially as well, and report differences as programming errors.")
     (warning-as-error
      #f
      "Change all warning and programming_error
@@ -797,22 +846,27 @@ messages into errors.")
 
 (define (profile-measurements)
   (let* ((t (times))
-         (stats (gc-stats)))
+         (stats (gc-stats))
+         (gc-time (assoc-get 'gc-time-taken stats 0)))
     (list (- (+ (tms:cutime t)
                 (tms:utime t))
-             (assoc-get 'gc-time-taken stats))
-          (assoc-get 'total-cells-allocated  stats 0))))
+             gc-time)
+          (assoc-get 'total-cells-allocated  stats 0)
+          gc-time
+          (assoc-get 'collections (ly:gc-statistics) 0))))
 
-(define (dump-profile base last this)
+(define (dump-profile base last this max-pause)
   (let* ((outname (format #f "~a.profile" (dir-basename base ".ly")))
-         (diff (map - this last)))
+         (diff (map - this last))
+         (cpu (lambda (x) (if (ly:get-option 'dump-cpu-profile) x 0))))
     (ly:progress "\nWriting timing to ~a...\n" outname)
     (format (open-file outname "w")
-            "time: ~a\ncells: ~a\n"
-            (if (ly:get-option 'dump-cpu-profile)
-                (car diff)
-                0)
-            (cadr diff))))
+            "time: ~a\ncells: ~a\ngctime: ~a\ncollections: ~a\ngcpause: ~a\n"
+            (cpu (first diff))
+            (second diff)
+            (cpu (third diff))
+            (cpu (fourth diff))
+            (cpu max-pause))))
 
 ;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;;
 ;; debug memory leaks
@@ -1015,7 +1069,9 @@ PIDs or the number of the process."
                    ;; must overwrite individual entries
                    (if (ly:get-option 'dump-profile)
                        (dump-profile "lily-run-total"
-                                     '(0 0) (profile-measurements)))
+                                     '(0 0 0 0) (profile-measurements)
+                                     (assoc-get 'max-pause
+                                                (ly:gc-statistics) 0)))
                    (if (null? errors)
                        (ly:exit 0 #f)
                        (ly:exit 1 #f))))))
@@ -1044,13 +1100,15 @@ PIDs or the number of the process."
                               "a")
                    (fdes->outport 2))))
          (do-measurements (ly:get-option 'dump-profile))
+         (max-pause 0)
          (handler (lambda (key failed-file)
                     (set! failed (append (list failed-file) failed)))))
     (gc)
     (for-each
      (lambda (x)
        (let* ((start-measurements (if do-measurements
-                                      (profile-measurements)
+                                      (begin (ly:gc-statistics #t)
+                                             (profile-measurements))
                                       #f))
               (base (dir-basename x ".ly"))
               (all-settings (ly:all-options)))
@@ -1063,8 +1121,20 @@ PIDs or the number of the process."
          (lilypond-file handler x)
          (ly:check-expected-warnings)
          (session-terminate)
+         (if (ly:get-option 'memory-report)
+             (ly:memory-report (format #f "end of ~a" base)))
+         (if (ly:get-option 'memoize-markup)
+             (let ((stats (ly:markup-cache-statistics)))
+               (ly:debug (_ "Markup cache: ~a hits, ~a misses, ~a uncacheable")
+                         (assoc-get 'hits stats)
+                         (assoc-get 'misses stats)
+                         (assoc-get 'uncacheable stats))
+               (ly:markup-cache-clear)))
          (if start-measurements
-             (dump-profile x start-measurements (profile-measurements)))
+             (let ((pause (assoc-get 'max-pause (ly:gc-statistics) 0)))
+               (set! max-pause (max pause max-pause))
+               (dump-profile x start-measurements (profile-measurements)
+                             pause)))
          (if (ly:get-option 'trace-memory-frequency)
              (begin (mtrace:stop-trace)
                     (mtrace:dump-results base)))
@@ -1091,7 +1161,8 @@ PIDs or the number of the process."
     (if ping-log
         (format ping-log "Failed files: ~a\n" failed))
     (if (ly:get-option 'dump-profile)
-        (dump-profile "lily-run-total" '(0 0) (profile-measurements)))
+        (dump-profile "lily-run-total" '(0 0 0 0) (profile-measurements)
+                      max-pause))
     failed))
 
 (define (lilypond-file handler file-name)
@@ -0,0 +1,520 @@
+;;;; This file is part of LilyPond, the GNU music typesetter.
+;;;;
+;;;; Copyright (C) 2026 The LilyPond development team
+;;;;
+;;;; LilyPond is free software: you can redistribute it and/or modify
+;;;; it under the terms of the GNU General Public License as published by
+;;;; the Free Software Foundation, either version 3 of the License, or
+;;;; (at your option) any later version.
+;;;;
+;;;; LilyPond is distributed in the hope that it will be useful,
+;;;; but WITHOUT ANY WARRANTY; without even the implied warranty of
+;;;; MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;;;; GNU General Public License for more details.
+;;;;
+;;;; You should have received a copy of the GNU General Public License
+;;;; along with LilyPond.  If not, see <http://www.gnu.org/licenses/>.
+
+;;;; Stencil expressions as PDF content stream operators.
+;;;;
+;;;; Coordinates are in LilyPond units; framework-pdf.scm sets up the
+;;;; transformation to PDF user space at the start of each page.
+;;;; Every expression draws relative to its own origin, and `placebox'
+;;;; wraps it in a translated graphics state.
+;;;;
+;;;; Fonts are collected while the pages are output; framework-pdf.scm
+;;;; writes the font objects once all pages are done.
+;;;;
+;;;; TODO:
+;;;;   * embedded-ps cannot be supported.
+;;;;   * CID-keyed CFF fonts.
+
+(define-module (scm output-pdf))
+
+(use-modules (guile)
+             (ice-9 optargs)
+             (srfi srfi-1)
+             (srfi srfi-13)
+             (lily))
+
+(define format ergonomic-simple-format)
+
+;;; Set by framework-pdf.scm.
+(define output-scale 1.0)
+
+;;;
+;;; Fonts
+;;;
+
+;; A font is a vector
+;;
+;;   #(ID KIND BASE-NAME PROGRAM GLYPHS USED COUNT)
+;;
+;; KIND is `simple' for name-keyed CFF and Type 1 fonts, which are
+;; addressed with one-byte codes through slices of 256 glyphs, or `cid'
+;; for TrueType fonts, which are addressed by glyph index.  PROGRAM is a
+;; procedure: (PROGRAM 'data) returns (FILE-KIND . DATA), where
+;; FILE-KIND is `cff', `truetype' or `type1'; for `type1', DATA is the
+;; list returned by ly:type1->pdf-segments.  (PROGRAM 'indices NAMES)
+;; returns the glyph indices of the glyphs NAMES.  GLYPHS maps glyph
+;; names to codes; USED is the reversed list of (CODE NAME . WIDTH)
+;; entries, WIDTH in thousandths of the font size.
+
+(define pdf-font-table (make-hash-table 31))
+(define pdf-font-list '())
+
+(define-public (pdf-reset-fonts)
+  (set! pdf-font-table (make-hash-table 31))
+  (set! pdf-font-list '()))
+
+(define-public (pdf-fonts)
+  (reverse pdf-font-list))
+
+(define-public (pdf-font-id font) (vector-ref font 0))
+(define-public (pdf-font-kind font) (vector-ref font 1))
+(define-public (pdf-font-base-name font) (vector-ref font 2))
+(define-public (pdf-font-program font) ((vector-ref font 3) 'data))
+(define-public (pdf-font-glyph-indices font names)
+  ((vector-ref font 3) 'indices names))
+(define-public (pdf-font-used-glyphs font) (reverse (vector-ref font 5)))
+
+(define-public (pdf-font-resource-name font slice)
+  (if (eq? (pdf-font-kind font) 'simple)
+      (format #f "F~a-~a" (pdf-font-id font) slice)
+      (format #f "F~a" (pdf-font-id font))))
+
+(define (pdf-font-lookup key kind base-name program)
+  (or (hash-ref pdf-font-table key)
+      (let ((font (vector (length pdf-font-list) kind
+                          (pdf-name-escape base-name) program
+                          (make-hash-table 257) '() 0)))
+        (hash-set! pdf-font-table key font)
+        (set! pdf-font-list (cons font pdf-font-list))
+        font)))
+
+(define (pdf-font-code font name width)
+  "Return the code for glyph NAME in FONT, registering it on first use."
+  (or (hash-ref (vector-ref font 4) name)
+      (let ((code (if (eq? (pdf-font-kind font) 'simple)
+                      (vector-ref font 6)
+                      (car (pdf-font-glyph-indices font (list name))))))
+        (hash-set! (vector-ref font 4) name code)
+        (vector-set! font 5 (acons code (cons name width)
+                                   (vector-ref font 5)))
+        (vector-set! font 6 (1+ (vector-ref font 6)))
+        code)))
+
+(define (pdf-name-escape name)
+  "Make NAME usable as a PDF name object."
+  (string-map (lambda (c)
+                (if (or (char-alphabetic? c) (char-numeric? c)
+                        (memv c '(#\- #\_ #\. #\+)))
+                    c
+                    #\_))
+              name))
+
+(define (hex-code code digits)
+  (string-pad (string-upcase (number->string code 16)) digits #\0))
+
+(define (show-glyphs font size placements)
+  "Show glyphs from FONT at SIZE.  PLACEMENTS is a list of
+@code{(X Y NAME WIDTH)}."
+  (let loop ((placements placements)
+             (slice #f)
+             (result '()))
+    (if (null? placements)
+        (string-append "BT\n" (string-concatenate (reverse result)) "ET\n")
+        (let* ((p (car placements))
+               (code (pdf-font-code font (third p) (fourth p)))
+               (simple? (eq? (pdf-font-kind font) 'simple))
+               (this-slice (if simple? (quotient code 256) 0))
+               (select (if (eqv? slice this-slice)
+                           ""
+                           (ly:format "/~a ~4f Tf\n"
+                                      (pdf-font-resource-name font this-slice)
+                                      size))))
+          (loop (cdr placements)
+                this-slice
+                (cons (ly:format "~a1 0 0 1 ~4f ~4f Tm <~a> Tj\n"
+                                 select (first p) (second p)
+                                 (if simple?
+                                     (hex-code (remainder code 256) 2)
+                                     (hex-code code 4)))
+                      result))))))
+
+(define (otf-glyph-indices font names)
+  (let ((table (make-hash-table 1031)))
+    (fold (lambda (name index)
+            (hash-set! table name index)
+            (1+ index))
+          0
+          (ly:otf-glyph-list font))
+    (map (lambda (name) (or (hash-ref table name) 0)) names)))
+
+(define (otf-font-for-pdf font)
+  (pdf-font-lookup (ly:font-file-name font) 'simple (ly:font-name font)
+                   (lambda (what . args)
+                     (if (eq? what 'data)
+                         (cons 'cff (ly:otf-font-table-data font "CFF "))
+                         (otf-glyph-indices font (car args))))))
+
+(define (physical-font-for-pdf pango-font ps-name cid?)
+  (let* ((pf (find (lambda (pf) (equal? (pango-pf-font-name pf) ps-name))
+                   (ly:pango-font-physical-fonts pango-font)))
+         (file-name (and pf (pango-pf-file-name pf)))
+         (font-index (if pf (pango-pf-fontindex pf) 0))
+         (font-format (and file-name
+                           (ly:get-font-format file-name font-index))))
+    (define (program file-kind data-thunk)
+      (lambda (what . args)
+        (if (eq? what 'data)
+            (cons file-kind (data-thunk))
+            (ly:ttf-glyph-indices file-name (car args) font-index))))
+    (cond
+     ((and (eq? font-format 'CFF) (not cid?))
+      (pdf-font-lookup file-name 'simple ps-name
+                       (program 'cff
+                                (lambda ()
+                                  (ly:otf->cff file-name font-index)))))
+     ((and (eq? font-format (string->symbol "Type 1")) (not cid?))
+      (pdf-font-lookup file-name 'simple ps-name
+                       (program 'type1
+                                (lambda ()
+                                  (ly:type1->pdf-segments file-name)))))
+     ((and (eq? font-format 'TrueType) (= font-index 0))
+      (pdf-font-lookup file-name 'cid ps-name
+                       (program 'truetype
+                                (lambda () (ly:gulp-file file-name)))))
+     (else
+      (ly:warning (_ "PDF backend cannot embed font ~S=~S")
+                  ps-name file-name)
+      #f))))
+
+;;;
+;;; Annotations
+;;;
+
+;; Links found on the current page, as (URI-OR-PAGE LLX LLY URX URY) in
+;; LilyPond units.  Links emitted through `placebox' are first stored in
+;; pending-links, and moved by the placebox offset.
+(define page-links '())
+(define pending-links '())
+
+(define-public (pdf-take-page-links)
+  (let ((links (reverse page-links)))
+    (set! page-links '())
+    links))
+
+(define (add-link! target x-ext y-ext)
+  (set! pending-links
+        (cons (list target (car x-ext) (car y-ext) (cdr x-ext) (cdr y-ext))
+              pending-links)))
+
+;;;
+;;; Drawing
+;;;
+
+(define (line-cap-code cap)
+  (case cap
+    ((butt) 0) ((round) 1) ((square) 2)
+    (else (ly:warning (_ "unknown line-cap-style: ~S")
+                      (symbol->string cap))
+          1)))
+
+(define (line-join-code join)
+  (case join
+    ((miter) 0) ((round) 1) ((bevel) 2)
+    (else (ly:warning (_ "unknown line-join-style: ~S")
+                      (symbol->string join))
+          1)))
+
+(define (stroke-or-fill fill?)
+  (if fill? "B\n" "S\n"))
+
+;; Control point distance for approximating a quarter circle.
+(define kappa 0.5522847498)
+
+(define (arc-segments rx ry start end)
+  "Path operators for the elliptic arc with radii RX and RY from
+parametric angle START to END (radians, END > START), starting at the
+current point."
+  (let* ((n (max 1 (inexact->exact (ceiling (/ (- end start) (/ PI 2))))))
+         (step (/ (- end start) n))
+         (k (* 4/3 (tan (/ step 4)))))
+    (string-concatenate
+     (map (lambda (i)
+            (let* ((a (+ start (* i step)))
+                   (b (+ a step)))
+              (ly:format "~4f ~4f ~4f ~4f ~4f ~4f c\n"
+                         (* rx (- (cos a) (* k (sin a))))
+                         (* ry (+ (sin a) (* k (cos a))))
+                         (* rx (+ (cos b) (* k (sin b))))
+                         (* ry (- (sin b) (* k (cos b))))
+                         (* rx (cos b))
+                         (* ry (sin b)))))
+          (iota n)))))
+
+(define (ellipse-path rx ry)
+  (string-append (ly:format "~4f 0 m\n" rx)
+                 (arc-segments rx ry 0 (* 2 PI))
+                 "h\n"))
+
+(define (char font i)
+  (ly:warning (_ "PDF backend does not support character ~a of font ~a")
+              i (ly:font-name font))
+  "")
+
+(define (circle radius thick fill)
+  (string-append (ly:format "~4f w\n" thick)
+                 (ellipse-path radius radius)
+                 (stroke-or-fill fill)))
+
+(define (dashed-line thick on off dx dy phase)
+  (ly:format "1 J ~4f w [~4f ~4f] ~4f d 0 0 m ~4f ~4f l S\n"
+             thick on off phase dx dy))
+
+(define (draw-line thick x1 y1 x2 y2)
+  (ly:format "1 J ~4f w ~4f ~4f m ~4f ~4f l S\n"
+             thick x1 y1 x2 y2))
+
+(define (ellipse x-radius y-radius thick fill)
+  (string-append (ly:format "~4f w\n" thick)
+                 (ellipse-path x-radius y-radius)
+                 (stroke-or-fill fill)))
+
+(define embedded-ps
+  (let ((warned #f))
+    (lambda (string)
+      (if (not warned)
+          (begin
+            (ly:warning (_ "PDF backend ignores embedded PostScript"))
+            (set! warned #t)))
+      "")))
+
+(define (end-group-node)
+  "")
+
+(define (glyph-string pango-font
+                      postscript-font-name
+                      size
+                      cid?
+                      w-x-y-named-glyphs)
+  (let ((font (physical-font-for-pdf pango-font postscript-font-name cid?))
+        (font-size (/ size output-scale)))
+    (if (not font)
+        ""
+        (let loop ((glyphs w-x-y-named-glyphs)
+                   (x 0.0)
+                   (placements '()))
+          (if (null? glyphs)
+              (show-glyphs font font-size (reverse placements))
+              (let* ((g (car glyphs))
+                     (w (first g))
+                     (name (fifth g)))
+                (loop (cdr glyphs)
+                      (+ x w)
+                      (cons (list (+ x (third g)) (fourth g)
+                                  (if (number? name)
+                                      (format #f "glyphIndex~a"
+                                              (number->string name 16))
+                                      name)
+                                  (round (* 1000 (/ w font-size))))
+                            placements))))))))
+
+(define (grob-cause offset grob)
+  (if (ly:get-option 'point-and-click)
+      (let* ((cause (ly:grob-property grob 'cause))
+             (music-origin (if (ly:stream-event? cause)
+                               (ly:event-property cause 'origin)))
+             (point-and-click (ly:get-option 'point-and-click)))
+        (if (and
+             (ly:input-location? music-origin)
+             (cond ((boolean? point-and-click) point-and-click)
+                   ((symbol? point-and-click)
+                    (ly:in-event-class? cause point-and-click))
+                   (else (any (lambda (t)
+                                (ly:in-event-class? cause t))
+                              point-and-click))))
+            (let* ((location (ly:input-file-line-char-column music-origin))
+                   (raw-file (car location))
+                   (file (if (is-absolute? raw-file)
+                             raw-file
+                             (string-append (ly-getcwd) "/" raw-file)))
+                   (x-ext (ly:grob-extent grob grob X))
+                   (y-ext (ly:grob-extent grob grob Y)))
+              (if (and (< 0 (interval-length x-ext))
+                       (< 0 (interval-length y-ext)))
+                  (set! page-links
+                        (cons (list (format #f "textedit://~a:~a:~a:~a"
+                                            (ly:string-percent-encode
+                                             (ly:string-substitute
+                                              "\\" "/" file))
+                                            (cadr location)
+                                            (caddr location)
+                                            (1+ (cadddr location)))
+                                    (+ (car offset) (car x-ext))
+                                    (+ (cdr offset) (car y-ext))
+                                    (+ (car offset) (cdr x-ext))
+                                    (+ (cdr offset) (cdr y-ext)))
+                              page-links)))))))
+  "")
+
+(define (named-glyph font glyph)
+  (if (ly:otf-font? font)
+      (show-glyphs (otf-font-for-pdf font)
+                   (* (ly:font-magnification font) (ly:font-design-size font))
+                   (list (list 0 0 glyph
+                               (round (* 1000 (ly:otf-glyph-advance
+                                               font glyph))))))
+      (begin
+        (ly:warning (_ "PDF backend cannot embed font ~S")
+                    (ly:font-name font))
+        "")))
+
+(define (no-origin)
+  "")
+
+(define (page-link page-no x y)
+  (if (number? page-no)
+      (add-link! page-no x y))
+  "")
+
+(define* (path thickness exps #:optional (cap 'round) (join 'round) (fill? #f))
+  (define (convert-path-exps exps x y)
+    (if (pair? exps)
+        (let* ((head (car exps))
+               (rest (cdr exps))
+               (arity
+                (cond
+                 ((memq head '(rmoveto rlineto lineto moveto)) 2)
+                 ((memq head '(rcurveto curveto)) 6)
+                 ((eq? head 'closepath) 0)
+                 (else 1)))
+               (args (take rest arity))
+               (relative (memq head '(rmoveto rlineto rcurveto)))
+               (points
+                (if relative
+                    (let loop ((a args) (odd #f))
+                      (if (null? a)
+                          '()
+                          (cons (+ (car a) (if odd y x))
+                                (loop (cdr a) (not odd)))))
+                    args))
+               (operator
+                (case head
+                  ((moveto rmoveto) "m")
+                  ((lineto rlineto) "l")
+                  ((curveto rcurveto) "c")
+                  ((closepath) "h")
+                  (else #f)))
+               (end (if (>= arity 2)
+                        (take-right points 2)
+                        (list x y))))
+          (if (not operator)
+              (begin
+                (ly:warning (_ "unknown path command: ~S") head)
+                (convert-path-exps (drop rest arity) x y))
+              (cons (ly:format "~4l ~a\n" points operator)
+                    (convert-path-exps (drop rest arity)
+                                       (first end) (second end)))))
+        '()))
+
+  (string-append
+   (ly:format "~a J ~a j ~4f w\n"
+              (line-cap-code cap) (line-join-code join) thickness)
+   (string-concatenate (convert-path-exps exps 0 0))
+   ;; print outline contour only if there is no fill or if
+   ;; contour is explicitly requested with a thickness > 0
+   (cond ((not fill?) "S\n")
+         ((positive? thickness) "B\n")
+         (else "f\n"))))
+
+(define (partial-ellipse x-radius y-radius start-angle end-angle thick connect fill)
+  ;; The angles are polar angles; convert them to parametric angles
+  ;; of the ellipse.
+  (define (parametric angle)
+    (let* ((rad (degrees->radians angle))
+           (t (atan (* x-radius (sin rad)) (* y-radius (cos rad)))))
+      (if (negative? t) (+ t (* 2 PI)) t)))
+  (let* ((start (parametric start-angle))
+         (end (parametric end-angle))
+         (end (if (<= end start) (+ end (* 2 PI)) end)))
+    (string-append
+     (ly:format "~4f w ~4f ~4f m\n"
+                thick
+                (* x-radius (cos start))
+                (* y-radius (sin start)))
+     (arc-segments x-radius y-radius start end)
+     (if connect "h\n" "")
+     (stroke-or-fill fill))))
+
+(define (placebox x y s)
+  (if (pair? pending-links)
+      (begin
+        (set! page-links
+              (append (map (lambda (l)
+                             (list (first l)
+                                   (+ x (second l)) (+ y (third l))
+                                   (+ x (fourth l)) (+ y (fifth l))))
+                           pending-links)
+                      page-links))
+        (set! pending-links '())))
+  (if (string-null? s)
+      ""
+      (ly:format "q 1 0 0 1 ~4f ~4f cm\n~aQ\n" x y s)))
+
+(define (polygon points blot-diameter filled?)
+  (let ((coords (ly:list->offsets '() points)))
+    (string-append
+     (ly:format "0 J 1 j ~4f w\n" blot-diameter)
+     (ly:format "~4f ~4f m\n" (caar coords) (cdar coords))
+     (string-concatenate
+      (map (lambda (c) (ly:format "~4f ~4f l\n" (car c) (cdr c)))
+           (cdr coords)))
+     (if filled? "b\n" "s\n"))))
+
+(define (round-filled-box left right bottom top blotdiam)
+  (let* ((halfblot (/ blotdiam 2))
+         (x (- halfblot left))
+         (y (- halfblot bottom))
+         (width (max 0 (- (+ left right) blotdiam)))
+         (height (max 0 (- (+ bottom top) blotdiam))))
+    (if (zero? blotdiam)
+        (ly:format "~4l re f\n" (list x y width height))
+        (ly:format "1 j ~4f w ~4l re B\n"
+                   blotdiam (list x y width height)))))
+
+(define (resetcolor)
+  "Q\n")
+
+(define (resetrotation ang x y)
+  "Q\n")
+
+(define (resetscale)
+  "Q\n")
+
+(define (setcolor r g b)
+  (ly:format "q ~4l rg ~4l RG\n" (list r g b) (list r g b)))
+
+;; rotation around given point
+(define (setrotation ang x y)
+  (let* ((rad (degrees->radians ang))
+         (c (cos rad))
+         (s (sin rad)))
+    (ly:format "q ~4l cm\n"
+               (list c s (- s) c
+                     (+ (- x (* c x)) (* s y))
+                     (- y (* s x) (* c y))))))
+
+(define (setscale x y)
+  (ly:format "q ~4f 0 0 ~4f 0 0 cm\n" x y))
+
+(define (start-group-node attributes)
+  "")
+
+(define (unknown)
+  "")
+
+(define (url-link url x y)
+  (add-link! url x y)
+  "")
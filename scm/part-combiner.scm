@@ -288,46 +288,12 @@ Voice-state objects
   "Interpret @var{music} according to @var{odef}, but store all events
 in a chronological list, similar to the @code{Recording_group_engraver} in
 LilyPond version 2.8 and earlier."
-  (let*
-      ((context-list '())
-       (now-mom (ly:make-moment 0 0))
-       (global (ly:make-global-context odef))
-       (mom-listener (lambda (tev) (set! now-mom (ly:event-property tev 'moment))))
-       (new-context-listener
-        (lambda (sev)
-          (let*
-              ((child (ly:event-property sev 'context))
-               (this-moment-list (cons (ly:context-id child) '()))
-               (dummy (set! context-list (cons this-moment-list context-list)))
-               (acc '())
-               (accumulate-event-listener
-                (lambda (ev)
-                  (set! acc (cons (cons ev #t) acc))))
-               (save-acc-listener
-                (lambda (tev)
-                  (if (pair? acc)
-                      (let ((this-moment
-                             (cons (cons now-mom
-                                         (ly:context-property child 'instrumentTransposition))
-                                   ;; The accumulate-event-listener above creates
-                                   ;; the list of events in reverse order, so we
-                                   ;; have to revert it to the original order again
-                                   (reverse acc))))
-                        (set-cdr! this-moment-list
-                                  (cons this-moment (cdr this-moment-list)))
-                        (set! acc '()))))))
-            (ly:add-listener accumulate-event-listener
-                             (ly:context-event-source child) 'StreamEvent)
-            (ly:add-listener save-acc-listener
-                             (ly:context-event-source global) 'OneTimeStep)))))
-    (ly:add-listener new-context-listener
-                     (ly:context-events-below global) 'AnnounceNewContext)
-    (ly:add-listener mom-listener (ly:context-event-source global) 'Prepare)
-    (ly:interpret-music-expression
-     (make-non-relative-music
-      (fold (lambda (x m) (x m)) music recording-group-functions))
-     global)
-    context-list))
+  (ly:record-context-events
+   (make-non-relative-music
+    (fold (lambda (x m) (x m)) music recording-group-functions))
+   odef))
+
+(call-after-session ly:clear-context-event-cache)
 
 (define-public (determine-split-list evl1 evl2 chord-range)
   "@var{evl1} and @var{evl2} should be ascending. @var{chord-range} is a pair of numbers (min . max) defining the distance in steps between notes that may be combined into a chord or unison."
@@ -908,7 +874,10 @@ the mark when there are no spanners active.
          (voicename (get-next-unique-voice-name))
          ;; recording-group-emulate returns an assoc list (reversed!), so
          ;; hand it a proper unique context name and extract that key:
-         (ctx-spec (context-spec-music mus 'Voice voicename))
+         ;; wrapped like the parts of \partcombine, so that both
+         ;; can share the recording of the same music:
+         (ctx-spec (context-spec-music (make-non-relative-music mus)
+                                       'Voice voicename))
          (listener (ly:parser-lookup 'partCombineListener))
          (context-list (reverse (recording-group-emulate ctx-spec listener)))
          (raw-voice (assoc voicename context-list))
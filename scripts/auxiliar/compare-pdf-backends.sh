@@ -0,0 +1,89 @@
+#!/bin/sh
+
+#  Compare PDF output of the PostScript and native PDF backends
+#
+#  Usage:  ./compare-pdf-backends.sh [-r RESOLUTION] [FILES...]
+#
+#    Every file is typeset twice: once through PostScript and
+#    Ghostscript (--pdf), and once with -dbackend=pdf.  The script
+#    reports run times, page counts, file sizes and whether the
+#    extracted text and the rasterized pages are identical.
+#
+#    -r sets the resolution used by pdftoppm for the page bitmaps;
+#    it defaults to 101.
+#
+#    In absence of any filenames, the contents of input/regression
+#    are used.  Results go to the pdf-backend-results directory.
+#
+#    Needs pdfinfo, pdftotext and pdftoppm from poppler-utils, and
+#    compare from ImageMagick.
+
+resolution=101
+
+while getopts "r:" opts; do
+    case $opts in
+	r)
+	    resolution=$OPTARG;;
+    esac
+done
+shift $((OPTIND-1))
+
+if [ -z "$LILYPOND_GIT" ]; then
+    echo "Need a LILYPOND_GIT environment variable!"
+    exit 1
+fi
+
+if [ $# -eq 0 ]; then
+    set -- $LILYPOND_GIT/input/regression/*.ly
+fi
+
+mkdir -p pdf-backend-results/ps pdf-backend-results/pdf
+cd pdf-backend-results
+
+now ()
+{
+    date +%s.%N
+}
+
+for file in "$@"; do
+    base=$(basename "$file" .ly)
+
+    start=$(now)
+    lilypond -s --pdf -o ps/$base "$file" 2>/dev/null
+    middle=$(now)
+    lilypond -s -dbackend=pdf -o pdf/$base "$file" 2>/dev/null
+    end=$(now)
+
+    if [ ! -f ps/$base.pdf ] || [ ! -f pdf/$base.pdf ]; then
+	echo "$base: missing output"
+	continue
+    fi
+
+    pages_ps=$(pdfinfo ps/$base.pdf | sed -n 's/^Pages: *//p')
+    pages_pdf=$(pdfinfo pdf/$base.pdf | sed -n 's/^Pages: *//p')
+
+    pdftotext ps/$base.pdf ps/$base.txt
+    pdftotext pdf/$base.pdf pdf/$base.txt
+    if cmp -s ps/$base.txt pdf/$base.txt; then
+	text=same
+    else
+	text=differs
+    fi
+
+    pdftoppm -r $resolution -gray ps/$base.pdf ps/$base
+    pdftoppm -r $resolution -gray pdf/$base.pdf pdf/$base
+    pixels=0
+    for page in ps/$base-*.pgm; do
+	other=pdf/${page#ps/}
+	if [ -f "$other" ]; then
+	    diff=$(compare -metric AE "$page" "$other" null: 2>&1)
+	    pixels=$((pixels + ${diff%% *}))
+	fi
+    done
+
+    echo "$base:" \
+	"time ps $(echo "$middle - $start" | bc) pdf $(echo "$end - $middle" | bc)," \
+	"pages $pages_ps/$pages_pdf," \
+	"size $(wc -c < ps/$base.pdf)/$(wc -c < pdf/$base.pdf)," \
+	"text $text, differing pixels $pixels"
+done
@@ -0,0 +1,583 @@
+#!@PYTHON@
+
+"""Time LilyPond on a fixed set of scores and compare builds.
+
+Every benchmark is run several times.  For each run the wall clock
+time of the processing phases (as announced by LilyPond's progress
+messages), the CPU time, the peak resident set size, the time spent
+in garbage collection, the number of collections and the longest
+collection pause, the number of allocated cells and the number of
+grobs are recorded.  Results can be saved as JSON and compared
+against an earlier run; differences in timing are only reported when
+Welch's t-test finds them significant.
+
+Besides a few real scores from the source tree, orchestral, piano and
+vocal scores of configurable length are generated.
+"""
+
+import math
+import optparse
+import os
+import random
+import re
+import subprocess
+import sys
+import time
+
+try:
+    import json
+except ImportError:
+    sys.stderr.write ('benchmark: needs Python 2.6 or newer\n')
+    sys.exit (2)
+
+options = None
+
+################################################################
+# the suite
+
+SIZES = ('small', 'medium', 'huge')
+
+## (name, size, file relative to the source tree)
+FILE_BENCHMARKS = [
+    ('sarabande', 'small', 'input/regression/baerenreiter-sarabande.ly'),
+    ('nereides', 'small', 'input/regression/les-nereides.ly'),
+    ('morgenlied', 'small', 'input/regression/morgenlied.ly'),
+    ('typography-demo', 'small', 'input/regression/typography-demo.ly'),
+    ('beam-quanting', 'small', 'input/regression/beam-quant-standard.ly'),
+    ('iteration', 'medium', 'scripts/auxiliar/iteration-benchmark.ly'),
+    ('dispatcher', 'medium', 'scripts/auxiliar/dispatcher-benchmark.ly'),
+    ('polyphony', 'medium', 'scripts/auxiliar/polyphony-benchmark.ly'),
+    ('articulations', 'medium', 'scripts/auxiliar/articulation-benchmark.ly'),
+    ]
+
+## (kind, size, length factor relative to --measures)
+SYNTHETIC_BENCHMARKS = [
+    ('orchestra', 'medium', 1),
+    ('piano', 'medium', 1),
+    ('vocal', 'medium', 1),
+    ('orchestra', 'huge', 8),
+    ('piano', 'huge', 8),
+    ('vocal', 'huge', 8),
+    ]
+
+################################################################
+# synthetic scores
+
+NOTE_NAMES = 'cdefgab'
+
+RHYTHMS = [
+    ['4', '4', '4', '4'],
+    ['8', '8', '4', '8', '8', '4'],
+    ['16', '16', '16', '16', '4', '8', '8', '4'],
+    ['2', '4', '4'],
+    ['4.', '8', '2'],
+    ['8', '8', '8', '8', '8', '8', '8', '8'],
+    ['tuplet', '4', '2'],
+    ['1'],
+    ]
+
+ARTICULATIONS = ['', '', '', '-.', '->', '--', '-^']
+DYNAMICS = ['\\pp', '\\p', '\\mp', '\\mf', '\\f', '\\ff']
+SYLLABLES = ['la', 'le', 'li', 'lo', 'lu', 'da', 'do', 'mi', 'na', 'so',
+             'ta', 're', 'ven', 'tus', 'glo', 'ri', 'a', 'san', 'ctus']
+
+def pitch_name (step):
+    """Absolute pitch for diatonic STEP, where 0 is c (below middle c)."""
+    octave = step // 7
+    name = NOTE_NAMES[step % 7]
+    if octave > 0:
+        return name + "'" * octave
+    return name + ',' * -octave
+
+class Voice_generator:
+    def __init__ (self, rng, low, high):
+        self.rng = rng
+        self.low = low
+        self.high = high
+        self.step = (low + high) // 2
+
+    def next_pitch (self):
+        self.step += self.rng.choice ([-2, -1, -1, 1, 1, 2, 3, -3])
+        if self.step < self.low or self.step > self.high:
+            self.step = (self.low + self.high) // 2
+        return pitch_name (self.step)
+
+    def chord (self):
+        base = self.step
+        return '<%s>' % ' '.join ([pitch_name (base + i) for i in (0, 2, 4)])
+
+    def measure (self, chords=False, slurs=True):
+        """Return one 4/4 measure and its number of syllables."""
+        rhythm = self.rng.choice (RHYTHMS)
+        notes = []
+        count = 0
+        slur_open = False
+        for i in range (len (rhythm)):
+            d = rhythm[i]
+            if d == 'tuplet':
+                group = ['%s8' % self.next_pitch () for j in range (3)]
+                notes.append ('\\tuplet 3/2 { %s }' % ' '.join (group))
+                count += 3
+                continue
+            p = self.next_pitch ()
+            if chords and d in ('4', '2', '4.', '1'):
+                self.step = max (self.low, min (self.step, self.high - 4))
+                p = self.chord ()
+            note = p + d + self.rng.choice (ARTICULATIONS)
+            if i == 0 and self.rng.random () < 0.2:
+                note += self.rng.choice (DYNAMICS)
+            if slurs and d in ('8', '16') and not slur_open \
+                    and i + 1 < len (rhythm) and rhythm[i + 1] == d:
+                note += '('
+                slur_open = True
+            elif slur_open and (i + 1 == len (rhythm) or rhythm[i + 1] != d):
+                note += ')'
+                slur_open = False
+            notes.append (note)
+            count += 1
+        if slur_open:
+            notes[-1] += ')'
+        return ' '.join (notes), count
+
+def lyrics (rng, count):
+    words = []
+    while count > 0:
+        length = min (count, rng.choice ([1, 1, 2, 3]))
+        word = [rng.choice (SYLLABLES) for i in range (length)]
+        words.append (' -- '.join (word))
+        count -= length
+    return ' '.join (words)
+
+def staff_music (rng, measures, low, high, clef, rests=0.0, chords=False,
+                 slurs=True):
+    gen = Voice_generator (rng, low, high)
+    bars = []
+    count = 0
+    for m in range (measures):
+        if m % 16 == 0 and m:
+            bars.append ('\\break' if rng.random () < 0.1 else '')
+        if rng.random () < rests:
+            bars.append ('R1 |')
+            continue
+        music, n = gen.measure (chords=chords, slurs=slurs)
+        bars.append (music + ' |')
+        count += n
+    return ('{ \\clef %s \\key g \\major \\time 4/4\n  %s\n  \\bar "|."\n}'
+            % (clef, '\n  '.join ([b for b in bars if b]))), count
+
+ORCHESTRA = [
+    ('Flute', 14, 24, 'treble', 0.3),
+    ('Oboe', 10, 20, 'treble', 0.3),
+    ('Clarinet', 7, 19, 'treble', 0.3),
+    ('Bassoon', -7, 5, 'bass', 0.3),
+    ('Horn', 3, 12, 'treble', 0.5),
+    ('Trumpet', 7, 16, 'treble', 0.6),
+    ('Trombone', -4, 6, 'bass', 0.6),
+    ('Timpani', -5, 1, 'bass', 0.7),
+    ('Violin I', 10, 24, 'treble', 0.05),
+    ('Violin II', 7, 19, 'treble', 0.05),
+    ('Viola', 2, 13, 'alto', 0.1),
+    ('Cello', -6, 7, 'bass', 0.1),
+    ('Contrabass', -10, 2, 'bass', 0.2),
+    ]
+
+def orchestra_score (rng, measures):
+    groups = [ORCHESTRA[0:4], ORCHESTRA[4:8], ORCHESTRA[8:]]
+    staves = []
+    for group in groups:
+        members = []
+        for (name, low, high, clef, rests) in group:
+            music, count = staff_music (rng, measures, low, high, clef, rests)
+            members.append ('\\new Staff \\with { instrumentName = "%s" }\n%s'
+                            % (name, music))
+        staves.append ('\\new StaffGroup <<\n%s\n>>' % '\n'.join (members))
+    return ('\\score {\n<<\n%s\n>>\n'
+            '\\layout { \\context { \\Staff \\RemoveEmptyStaves } }\n}\n'
+            % '\n'.join (staves))
+
+def piano_score (rng, measures):
+    right, count = staff_music (rng, measures, 7, 21, 'treble', chords=True)
+    left, count = staff_music (rng, measures, -10, 3, 'bass', chords=True)
+    pedal = ' '.join (['s2\\sustainOn s2\\sustainOff'] * measures)
+    return ('\\score {\n\\new PianoStaff <<\n'
+            '\\new Staff = "up" %s\n'
+            '\\new Staff = "down" << %s { %s } >>\n'
+            '>>\n\\layout { }\n}\n' % (right, left, pedal))
+
+def vocal_score (rng, measures):
+    parts = []
+    for (name, low, high, clef) in [('Soprano', 7, 16, 'treble'),
+                                    ('Alto', 4, 12, 'treble'),
+                                    ('Tenor', 0, 9, '"treble_8"'),
+                                    ('Bass', -5, 4, 'bass')]:
+        music, count = staff_music (rng, measures, low, high, clef,
+                                    slurs=False)
+        voice = name.lower ()
+        parts.append ('\\new Staff \\with { instrumentName = "%s" } <<\n'
+                      '\\new Voice = "%s" %s\n'
+                      '\\new Lyrics \\lyricsto "%s" { %s }\n>>'
+                      % (name, voice, music, voice, lyrics (rng, count)))
+    right, count = staff_music (rng, measures, 7, 18, 'treble', chords=True)
+    left, count = staff_music (rng, measures, -8, 3, 'bass', chords=True)
+    return ('\\score {\n<<\n\\new ChoirStaff <<\n%s\n>>\n'
+            '\\new PianoStaff << \\new Staff %s \\new Staff %s >>\n'
+            '>>\n\\layout { }\n}\n'
+            % ('\n'.join (parts), right, left))
+
+GENERATORS = {
+    'orchestra': orchestra_score,
+    'piano': piano_score,
+    'vocal': vocal_score,
+    }
+
+def write_synthetic (kind, measures, file_name):
+    rng = random.Random ('%s-%d' % (kind, measures))
+    f = open (file_name, 'w')
+    f.write ('\\version "2.19.62"\n'
+             '%% Generated by benchmark.py; %s score, %d measures.\n\n'
+             % (kind, measures))
+    f.write (GENERATORS[kind] (rng, measures))
+    f.close ()
+
+def suite ():
+    """Return a list of (name, size, file name), honoring the options."""
+    result = []
+    for (name, size, path) in FILE_BENCHMARKS:
+        result.append ((name, size, os.path.join (options.src_dir, path)))
+    for (kind, size, factor) in SYNTHETIC_BENCHMARKS:
+        measures = options.measures * factor
+        name = '%s-%d' % (kind, measures)
+        file_name = os.path.join (options.output_dir, name + '.ly')
+        result.append ((name, size, file_name))
+
+    wanted = SIZES[:list (SIZES).index (options.size) + 1]
+    return [b for b in result
+            if b[1] in wanted and re.search (options.filter, b[0])]
+
+################################################################
+# running
+
+## Progress messages that start a phase.  Times are attributed to the
+## phase of the most recent message.
+PHASES = [
+    ('parsing', 'Parsing\\.\\.\\.'),
+    ('interpreting', 'Interpreting music\\.\\.\\.'),
+    ('preprocessing', 'Preprocessing graphical objects\\.\\.\\.'),
+    ('breaking', 'Calculating line breaks\\.\\.\\.'
+     '|Finding the ideal number of pages\\.\\.\\.'
+     '|Calculating page breaks\\.\\.\\.'),
+    ('drawing', 'Drawing systems\\.\\.\\.'),
+    ('output', 'Layout output to'),
+    ]
+
+def run_lilypond (file_name):
+    """Run LilyPond once on FILE_NAME.  Return a dict of measurements."""
+    base = os.path.splitext (os.path.basename (file_name))[0]
+    profile = os.path.join (options.output_dir, base + '.profile')
+    if os.path.exists (profile):
+        os.unlink (profile)
+
+    cmd = [options.lilypond,
+           '--loglevel=DEBUG',
+           '-dbackend=ps', '--formats=ps',
+           '-ddump-profile', '-ddump-cpu-profile']
+    cmd += ['-d' + d for d in options.define]
+    cmd += ['-o', base, file_name]
+    env = dict (os.environ)
+    env['LANG'] = env['LC_ALL'] = env['LANGUAGE'] = 'C'
+
+    start = time.time ()
+    proc = subprocess.Popen (cmd, cwd=options.output_dir, env=env,
+                             stdout=subprocess.PIPE,
+                             stderr=subprocess.STDOUT)
+
+    regexes = [(p, re.compile (r)) for (p, r) in PHASES]
+    phases = {}
+    current = 'startup'
+    last = start
+    pending = ''
+    log = []
+    while True:
+        chunk = os.read (proc.stdout.fileno (), 4096)
+        if not chunk:
+            break
+        now = time.time ()
+        chunk = chunk.decode ('latin-1')
+        log.append (chunk)
+        pending += chunk
+        while True:
+            found = None
+            for (phase, regex) in regexes:
+                m = regex.search (pending)
+                if m and (not found or m.start () < found[1].start ()):
+                    found = (phase, m)
+            if not found:
+                break
+            phases[current] = phases.get (current, 0.0) + now - last
+            current = found[0]
+            last = now
+            pending = pending[found[1].end ():]
+        pending = pending[-100:]
+
+    (pid, status, usage) = os.wait4 (proc.pid, 0)
+    end = time.time ()
+    phases[current] = phases.get (current, 0.0) + end - last
+
+    log = ''.join (log)
+    open (os.path.join (options.output_dir, base + '.bench.log'),
+          'w').write (log)
+    if not os.WIFEXITED (status) or os.WEXITSTATUS (status):
+        raise RuntimeError ('%s failed, see %s.bench.log' % (file_name, base))
+
+    result = {
+        'wall': end - start,
+        'cpu': usage.ru_utime + usage.ru_stime,
+        'rss_kb': float (usage.ru_maxrss),
+        'grobs': float (sum ([int (n) for n in re.findall (
+                    'Element count ([0-9]+) \\(spanners', log)])),
+        }
+    for (phase, t) in phases.items ():
+        result['phase:' + phase] = t
+
+    ## time and gctime are in the same units; only their ratio is used.
+    if os.path.exists (profile):
+        values = dict (re.findall ('([a-z]+): ([-0-9.]+)\n',
+                                   open (profile).read ()))
+        lily_time = float (values.get ('time', 0))
+        gc_time = float (values.get ('gctime', 0))
+        result['cells'] = float (values.get ('cells', 0))
+        for key in ('collections', 'gcpause'):
+            if key in values:
+                result[key] = float (values[key])
+        if lily_time + gc_time > 0:
+            result['gc'] = usage.ru_utime * gc_time / (lily_time + gc_time)
+    return result
+
+def lilypond_version ():
+    try:
+        proc = subprocess.Popen ([options.lilypond, '--version'],
+                                 stdout=subprocess.PIPE)
+        return proc.communicate ()[0].decode ('latin-1').split ('\n')[0]
+    except OSError:
+        return 'unknown'
+
+def run_suite ():
+    if not os.path.isdir (options.output_dir):
+        os.makedirs (options.output_dir)
+
+    results = {
+        'lilypond': options.lilypond,
+        'version': lilypond_version (),
+        'date': time.strftime ('%Y-%m-%d %H:%M:%S'),
+        'host': os.uname ()[1],
+        'runs': options.runs,
+        'benchmarks': {},
+        }
+    for (name, size, file_name) in suite ():
+        if not os.path.exists (file_name):
+            kind, measures = name.rsplit ('-', 1)
+            write_synthetic (kind, int (measures), file_name)
+
+        samples = {}
+        sys.stderr.write ('%-24s' % name)
+        for i in range (options.runs):
+            measured = run_lilypond (file_name)
+            for (k, v) in measured.items ():
+                samples.setdefault (k, []).append (v)
+            sys.stderr.write (' %.2fs' % measured['wall'])
+        sys.stderr.write ('\n')
+        results['benchmarks'][name] = {'size': size, 'samples': samples}
+    return results
+
+################################################################
+# statistics
+
+def mean (xs):
+    return sum (xs) / float (len (xs))
+
+def variance (xs):
+    if len (xs) < 2:
+        return 0.0
+    m = mean (xs)
+    return sum ([(x - m) ** 2 for x in xs]) / (len (xs) - 1)
+
+def incomplete_beta_fraction (a, b, x):
+    """Continued fraction for the incomplete beta function (Lentz)."""
+    tiny = 1e-300
+    c = 1.0
+    d = 1.0 - (a + b) * x / (a + 1)
+    if abs (d) < tiny:
+        d = tiny
+    d = 1.0 / d
+    h = d
+    for m in range (1, 300):
+        m2 = 2 * m
+        aa = m * (b - m) * x / ((a + m2 - 1) * (a + m2))
+        for step in (aa, -(a + m) * (a + b + m) * x / ((a + m2) * (a + m2 + 1))):
+            d = 1.0 + step * d
+            if abs (d) < tiny:
+                d = tiny
+            c = 1.0 + step / c
+            if abs (c) < tiny:
+                c = tiny
+            d = 1.0 / d
+            h *= d * c
+        if abs (d * c - 1.0) < 1e-12:
+            break
+    return h
+
+def regularized_beta (a, b, x):
+    if x <= 0.0:
+        return 0.0
+    if x >= 1.0:
+        return 1.0
+    log_front = (math.lgamma (a + b) - math.lgamma (a) - math.lgamma (b)
+                 + a * math.log (x) + b * math.log (1.0 - x))
+    if x < (a + 1) / (a + b + 2):
+        return math.exp (log_front) * incomplete_beta_fraction (a, b, x) / a
+    return 1.0 - (math.exp (log_front)
+                  * incomplete_beta_fraction (b, a, 1.0 - x) / b)
+
+def welch_p_value (xs, ys):
+    """Two-sided p-value of Welch's t-test for equal means."""
+    if len (xs) < 2 or len (ys) < 2:
+        return 1.0
+    vx = variance (xs) / len (xs)
+    vy = variance (ys) / len (ys)
+    if vx + vy == 0.0:
+        if mean (xs) == mean (ys):
+            return 1.0
+        return 0.0
+    t = (mean (xs) - mean (ys)) / math.sqrt (vx + vy)
+    df = (vx + vy) ** 2 / (vx ** 2 / (len (xs) - 1) + vy ** 2 / (len (ys) - 1))
+    return regularized_beta (df / 2.0, 0.5, df / (df + t * t))
+
+################################################################
+# reporting
+
+## Counts that do not depend on the machine; any change is reported.
+EXACT_METRICS = ('cells', 'grobs')
+
+def compare (old, new):
+    """Print a comparison of two result sets.  Return the number of
+    significant regressions."""
+    regressions = 0
+    lines = []
+    for name in sorted (new['benchmarks'].keys ()):
+        if name not in old['benchmarks']:
+            continue
+        a = old['benchmarks'][name]['samples']
+        b = new['benchmarks'][name]['samples']
+        for metric in sorted (b.keys ()):
+            if metric not in a or not mean (a[metric]):
+                continue
+            before = mean (a[metric])
+            after = mean (b[metric])
+            change = (after - before) / before
+            if metric in EXACT_METRICS:
+                significant = after != before
+                p = 0.0
+            else:
+                p = welch_p_value (a[metric], b[metric])
+                significant = (p < options.alpha
+                               and abs (change) > options.threshold / 100.0)
+            if not significant and not options.verbose:
+                continue
+            verdict = ''
+            if significant:
+                verdict = 'slower' if change > 0 else 'faster'
+                if (metric in EXACT_METRICS or metric.startswith ('rss')
+                    or metric == 'collections'):
+                    verdict = 'more' if change > 0 else 'less'
+                if change > 0:
+                    regressions += 1
+            lines.append ('%-24s %-22s %12.4g %12.4g %+7.1f%%  p=%.3f  %s'
+                          % (name, metric, before, after, 100 * change,
+                             p, verdict))
+
+    sys.stdout.write ('comparing %s (%s)\n     with %s (%s)\n\n'
+                      % (old['version'], old['date'],
+                         new['version'], new['date']))
+    if lines:
+        sys.stdout.write ('%-24s %-22s %12s %12s %8s\n'
+                          % ('benchmark', 'metric', 'before', 'after',
+                             'change'))
+        sys.stdout.write ('\n'.join (lines) + '\n')
+    sys.stdout.write ('\n%d significant regression(s)\n' % regressions)
+    return regressions
+
+def summary (results):
+    sys.stdout.write ('%-24s %10s %10s %10s %10s %10s\n'
+                      % ('benchmark', 'wall', 'cpu', 'gc', 'rss MB',
+                         'grobs'))
+    for name in sorted (results['benchmarks'].keys ()):
+        s = results['benchmarks'][name]['samples']
+        def m (k):
+            if k in s:
+                return mean (s[k])
+            return 0.0
+        sys.stdout.write ('%-24s %10.2f %10.2f %10.2f %10.1f %10d\n'
+                          % (name, m ('wall'), m ('cpu'), m ('gc'),
+                             m ('rss_kb') / 1024, int (m ('grobs'))))
+
+def load (file_name):
+    return json.load (open (file_name))
+
+def main ():
+    global options
+    p = optparse.OptionParser (
+        usage='%prog [OPTION]...\n'
+        '       %prog --report OLD.json NEW.json',
+        description=__doc__)
+    p.add_option ('--lilypond', default='lilypond',
+                  help='LilyPond binary to benchmark')
+    p.add_option ('--src-dir', default='.',
+                  help='top of the LilyPond source tree')
+    p.add_option ('--output-dir', default='out/bench',
+                  help='directory for scores, output and logs')
+    p.add_option ('--runs', type='int', default=5,
+                  help='number of runs per benchmark [%default]')
+    p.add_option ('--size', choices=SIZES, default='medium',
+                  help='largest benchmarks to run: small, medium or huge'
+                  ' [%default]')
+    p.add_option ('--measures', type='int', default=64,
+                  help='length of the medium synthetic scores [%default]')
+    p.add_option ('--define', '-d', action='append', default=[],
+                  metavar='OPTION',
+                  help='pass -dOPTION to LilyPond; may be repeated')
+    p.add_option ('--filter', default='',
+                  help='only run benchmarks matching this regular expression')
+    p.add_option ('--save', metavar='FILE',
+                  help='write the results as JSON to FILE')
+    p.add_option ('--baseline', metavar='FILE',
+                  help='compare the results with those in FILE')
+    p.add_option ('--report', action='store_true',
+                  help='compare two result files instead of running')
+    p.add_option ('--alpha', type='float', default=0.05,
+                  help='significance level [%default]')
+    p.add_option ('--threshold', type='float', default=3.0,
+                  help='ignore changes below this percentage [%default]')
+    p.add_option ('--verbose', action='store_true',
+                  help='also list changes that are not significant')
+    (options, args) = p.parse_args ()
+
+    if options.report:
+        if len (args) != 2:
+            p.error ('--report needs two result files')
+        return compare (load (args[0]), load (args[1])) and 1
+
+    options.output_dir = os.path.abspath (options.output_dir)
+    options.src_dir = os.path.abspath (options.src_dir)
+    results = run_suite ()
+    if options.save:
+        f = open (options.save, 'w')
+        json.dump (results, f, indent=1, sort_keys=True)
+        f.close ()
+    summary (results)
+    if options.baseline:
+        sys.stdout.write ('\n')
+        return compare (load (options.baseline), results) and 1
+    return 0
+
+if __name__ == '__main__':
+    sys.exit (main ())